@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#include "../src/Classifier.hpp"
+#include "../src/io/InputFile.hpp"
+#include "../src/vle.hpp"
+#include "../src/vle/GbSequence.hpp"
+#include "../src/vle/GbValidator.hpp"
+#include "../src/vle/unicode/Utf16Sequence.hpp"
+#include "../src/vle/unicode/Utf16Validator.hpp"
+#include "../src/vle/unicode/Utf8Sequence.hpp"
+#include "../src/vle/unicode/Utf8Validator.hpp"
+
+// Throughput of the validators and the classifier. Byte rates are in bytes_per_second and file rates in
+// the files counter; --benchmark_format=json or --benchmark_out=FILE records them for comparison.
+// Usage: file_bench [TEST_FILES_DIRECTORY] [benchmark options]
+
+namespace {
+    using Bytes = std::vector<std::uint8_t>;
+
+    constexpr std::size_t syntheticSize{16 * 1024 * 1024};
+    constexpr std::size_t tinyFileCount{2000};
+    constexpr std::size_t tinyFileSize{64};
+
+    enum class Input { ascii, utf8Cjk, utf16Cjk, gbCjk, lateByte };
+
+    // Fills size bytes by repeating a pattern, keeping multi-byte sequences whole.
+    Bytes repeat(const std::span<const std::uint8_t> pattern, const std::size_t size, const Bytes& prefix = {}) {
+        Bytes bytes{prefix};
+        while (bytes.size() + pattern.size() <= size) {
+            bytes.insert(bytes.end(), pattern.begin(), pattern.end());
+        }
+        return bytes;
+    }
+
+    Bytes generate(const Input input, const std::size_t size) {
+        static constexpr std::uint8_t asciiText[]{'T', 'h', 'e', ' ', 'q', 'u', 'i', 'c', 'k', ' ', 'f', 'o', 'x', '\n'};
+        // "漢字 text, " in each encoding: two ideographs followed by ASCII.
+        static constexpr std::uint8_t utf8Cjk[]{
+            0xE6, 0xBC, 0xA2, 0xE5, 0xAD, 0x97, ' ', 't', 'e', 'x', 't', ',', ' '
+        };
+        static constexpr std::uint8_t utf16Cjk[]{
+            0x22, 0x6F, 0x57, 0x5B, ' ', 0x00, 't', 0x00, 'e', 0x00, 'x', 0x00, 't', 0x00, ',', 0x00, ' ', 0x00
+        };
+        static constexpr std::uint8_t gbCjk[]{0xBA, 0xBA, 0xD7, 0xD6, ' ', 't', 'e', 'x', 't', ',', ' '};
+        switch (input) {
+            case Input::ascii:
+                return repeat(asciiText, size);
+            case Input::utf8Cjk:
+                return repeat(utf8Cjk, size);
+            case Input::utf16Cjk:
+                return repeat(utf16Cjk, size, {0xFF, 0xFE});
+            case Input::gbCjk:
+                return repeat(gbCjk, size);
+            case Input::lateByte: {
+                // Valid in every encoding until the last byte, so nothing can stop early.
+                Bytes bytes{repeat(asciiText, size - 1)};
+                bytes.push_back(0xFF);
+                return bytes;
+            }
+        }
+        return {};
+    }
+
+    const Bytes& cached(const Input input) {
+        static std::vector<std::optional<Bytes>> inputs(static_cast<std::size_t>(Input::lateByte) + 1);
+        std::optional<Bytes>& slot{inputs[static_cast<std::size_t>(input)]};
+        if (!slot.has_value()) {
+            slot.emplace(generate(input, syntheticSize));
+        }
+        return *slot;
+    }
+
+    template<typename Point, File::Vle<Point> Sequence>
+    bool validateSequences(const std::span<const Point> points) {
+        // Through consume, which runs validateVle one point at a time, so the optional stays out of the
+        // benchmark loop where GCC loses track of whether its payload was ever written.
+        std::optional<Sequence> pending{};
+        return Sequence::consume(pending, points) && !pending.has_value();
+    }
+
+    std::vector<std::uint16_t> littleEndianUnits(const Bytes& bytes) {
+        std::vector<std::uint16_t> units(bytes.size() / 2);
+        for (std::size_t i = 0; i < units.size(); i++) {
+            units[i] = static_cast<std::uint16_t>(bytes[2 * i] | bytes[2 * i + 1] << 8);
+        }
+        return units;
+    }
+
+    void utf8SequencePerByte(benchmark::State& state, const Input input) {
+        const Bytes& bytes{cached(input)};
+        for (auto _: state) {
+            benchmark::DoNotOptimize(validateSequences<std::uint8_t, File::Unicode::Utf8Sequence>(bytes));
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+    }
+
+    void utf16SequencePerByte(benchmark::State& state, const Input input) {
+        const Bytes& bytes{cached(input)};
+        const std::vector units{littleEndianUnits(bytes)};
+        for (auto _: state) {
+            benchmark::DoNotOptimize(validateSequences<std::uint16_t, File::Unicode::Utf16Sequence>(units));
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * units.size() * 2));
+    }
+
+    void gbSequencePerByte(benchmark::State& state, const Input input) {
+        const Bytes& bytes{cached(input)};
+        for (auto _: state) {
+            benchmark::DoNotOptimize(validateSequences<std::uint8_t, File::GbSequence>(bytes));
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+    }
+
+    // Feeds the input in blocks of state.range(0) bytes, as a chunked reader would.
+    template<class Validator>
+    void validatorPerBlock(benchmark::State& state, const Input input) {
+        const Bytes& bytes{cached(input)};
+        const auto blockSize{static_cast<std::size_t>(state.range(0))};
+        for (auto _: state) {
+            Validator validator{};
+            const std::span<const std::uint8_t> all{bytes};
+            for (std::size_t offset = 0; offset < all.size(); offset += blockSize) {
+                if (!validator.consume(all.subspan(offset, std::min(blockSize, all.size() - offset)))) {
+                    break;
+                }
+            }
+            benchmark::DoNotOptimize(validator.isValid());
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+    }
+
+    void classifierSynthetic(benchmark::State& state, const Input input) {
+        const Bytes& bytes{cached(input)};
+        const std::span<const std::uint8_t> all{bytes};
+        for (auto _: state) {
+            File::Classifier classifier{};
+            for (std::size_t offset = 0; offset < all.size() && !classifier.isDecided();
+                 offset += File::Classifier::blockSize) {
+                classifier.feed(all.subspan(offset, std::min(File::Classifier::blockSize, all.size() - offset)));
+            }
+            benchmark::DoNotOptimize(classifier.finish());
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+    }
+
+    // Open, read and classify, as file does for each path on its command line.
+    std::uint64_t classifyPath(const std::filesystem::path& path) {
+        std::optional input{File::Io::InputFile::open(path)};
+        if (!input.has_value()) {
+            return 0;
+        }
+        File::Classifier classifier{};
+        for (std::span block{input->next()}; !block.empty() && !classifier.isDecided(); block = input->next()) {
+            classifier.feed(block);
+        }
+        benchmark::DoNotOptimize(classifier.finish());
+        return classifier.bytesFed();
+    }
+
+    void classifierFile(benchmark::State& state, const std::filesystem::path& path) {
+        std::uint64_t bytes{0};
+        for (auto _: state) {
+            bytes += classifyPath(path);
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+        state.counters["files"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                     benchmark::Counter::kIsRate);
+    }
+
+    class TinyFiles {
+        std::filesystem::path m_directory;
+        std::vector<std::filesystem::path> m_paths;
+
+    public:
+        TinyFiles() : m_directory{std::filesystem::temp_directory_path() / ("file_bench." + std::to_string(getpid()))} {
+            std::filesystem::create_directories(m_directory);
+            const Bytes bytes{generate(Input::utf8Cjk, tinyFileSize)};
+            for (std::size_t i = 0; i < tinyFileCount; i++) {
+                m_paths.push_back(m_directory / std::to_string(i));
+                std::ofstream{m_paths.back(), std::ios::binary}.write(reinterpret_cast<const char*>(bytes.data()),
+                                                                      static_cast<std::streamsize>(bytes.size()));
+            }
+        }
+
+        TinyFiles(const TinyFiles&) = delete;
+
+        TinyFiles& operator=(const TinyFiles&) = delete;
+
+        ~TinyFiles() {
+            std::error_code error{};
+            std::filesystem::remove_all(m_directory, error);
+        }
+
+        [[nodiscard]] const std::vector<std::filesystem::path>& paths() const noexcept {
+            return m_paths;
+        }
+    };
+
+    void classifierTinyFiles(benchmark::State& state, const TinyFiles& files) {
+        std::uint64_t bytes{0};
+        for (auto _: state) {
+            for (const std::filesystem::path& path: files.paths()) {
+                bytes += classifyPath(path);
+            }
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+        state.counters["files"] = benchmark::Counter(static_cast<double>(state.iterations() * files.paths().size()),
+                                                     benchmark::Counter::kIsRate);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    benchmark::Initialize(&argc, argv);
+    const std::filesystem::path testFiles{argc > 1 ? argv[1] : FILE_TEST_FILES};
+
+    constexpr std::pair<Input, const char*> inputs[]{
+        {Input::ascii, "ascii"}, {Input::utf8Cjk, "utf8_cjk"}, {Input::utf16Cjk, "utf16_cjk"},
+        {Input::gbCjk, "gb_cjk"}, {Input::lateByte, "late_byte"}
+    };
+    for (const auto& [input, name]: inputs) {
+        const std::string suffix{std::string{"/"} + name};
+        benchmark::RegisterBenchmark(("Utf8Sequence/byte" + suffix).c_str(), utf8SequencePerByte, input);
+        benchmark::RegisterBenchmark(("Utf16Sequence/byte" + suffix).c_str(), utf16SequencePerByte, input);
+        benchmark::RegisterBenchmark(("GbSequence/byte" + suffix).c_str(), gbSequencePerByte, input);
+        benchmark::RegisterBenchmark(("Utf8Validator/block" + suffix).c_str(),
+                                     validatorPerBlock<File::Unicode::Utf8Validator>, input)
+                ->Arg(4 * 1024)->Arg(256 * 1024);
+        benchmark::RegisterBenchmark(("Utf16Validator/block" + suffix).c_str(),
+                                     validatorPerBlock<File::Unicode::Utf16Validator>, input)
+                ->Arg(4 * 1024)->Arg(256 * 1024);
+        benchmark::RegisterBenchmark(("GbValidator/block" + suffix).c_str(),
+                                     validatorPerBlock<File::GbValidator>, input)
+                ->Arg(4 * 1024)->Arg(256 * 1024);
+        benchmark::RegisterBenchmark(("Classifier/synthetic" + suffix).c_str(), classifierSynthetic, input);
+    }
+
+    std::vector<std::filesystem::path> corpus{};
+    std::error_code error{};
+    for (const std::filesystem::directory_entry& entry: std::filesystem::directory_iterator{testFiles, error}) {
+        if (entry.is_regular_file()) {
+            corpus.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(corpus);
+    for (const std::filesystem::path& path: corpus) {
+        benchmark::RegisterBenchmark(("Classifier/file/" + path.filename().string()).c_str(), classifierFile, path);
+    }
+    const TinyFiles tinyFiles{};
+    benchmark::RegisterBenchmark("Classifier/tiny_files", classifierTinyFiles, std::cref(tinyFiles));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return EXIT_SUCCESS;
+}
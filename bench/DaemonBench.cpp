@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../src/daemon/Client.hpp"
+
+// Compares the latency of asking a running file --daemon about a path with starting file for it.
+// Usage: file_daemon_bench SOCKET FILE_BINARY PATH [REQUESTS]
+
+extern char** environ;
+
+using Clock = std::chrono::steady_clock;
+
+void report(const std::string_view name, std::vector<double>& micros) {
+    std::ranges::sort(micros);
+    double total{0};
+    for (const double value: micros) {
+        total += value;
+    }
+    std::cout << name << ": mean " << total / static_cast<double>(micros.size()) << " us, p50 "
+              << micros[micros.size() / 2] << " us, p99 " << micros[micros.size() * 99 / 100] << " us\n";
+}
+
+double elapsedMicros(const Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+int main(const int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: file_daemon_bench SOCKET FILE_BINARY PATH [REQUESTS]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::size_t requests{argc > 4 ? std::stoul(argv[4]) : 1000};
+    std::optional client{File::Daemon::Client::connect(argv[1])};
+    if (!client.has_value()) {
+        std::cerr << "Unable to connect to " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<double> micros{};
+    micros.reserve(requests);
+    for (std::size_t i = 0; i < requests; i++) {
+        const Clock::time_point start{Clock::now()};
+        if (!client->classifyPath(argv[3]).has_value()) {
+            std::cerr << "Request failed" << std::endl;
+            return EXIT_FAILURE;
+        }
+        micros.push_back(elapsedMicros(start));
+    }
+    report("daemon, one at a time", micros);
+
+    micros.clear();
+    const Clock::time_point batchStart{Clock::now()};
+    for (std::size_t i = 0; i < requests; i++) {
+        client->queuePath(argv[3]);
+    }
+    if (!client->flush()) {
+        std::cerr << "Request failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (std::size_t i = 0; i < requests; i++) {
+        if (!client->receive().has_value()) {
+            std::cerr << "Request failed" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    micros.push_back(elapsedMicros(batchStart) / static_cast<double>(requests));
+    report("daemon, pipelined", micros);
+
+    micros.clear();
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    char* arguments[]{argv[2], argv[3], nullptr};
+    for (std::size_t i = 0; i < requests; i++) {
+        const Clock::time_point start{Clock::now()};
+        pid_t child;
+        int status;
+        if (posix_spawn(&child, argv[2], &actions, nullptr, arguments, environ) != 0 ||
+            waitpid(child, &status, 0) < 0) {
+            std::cerr << "Unable to run " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+        micros.push_back(elapsedMicros(start));
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    report("fork/exec", micros);
+    return EXIT_SUCCESS;
+}
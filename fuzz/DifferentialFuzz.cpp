@@ -0,0 +1,497 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../src/ChunkSummary.hpp"
+#include "../src/Classifier.hpp"
+#include "../src/FileType.hpp"
+#include "../src/simd/Ascii.hpp"
+#include "../src/simd/ByteClass.hpp"
+#include "../src/simd/Cpu.hpp"
+#include "../src/vle/GbSequence.hpp"
+#include "../src/vle/GbValidator.hpp"
+#include "../src/vle/Latin1.hpp"
+#include "../src/vle/Unicode.hpp"
+#include "../src/vle/unicode/Utf16Sequence.hpp"
+#include "../src/vle/unicode/Utf16Validator.hpp"
+#include "../src/vle/unicode/Utf8Sequence.hpp"
+#include "../src/vle/unicode/Utf8Validator.hpp"
+#include "BaselineSequences.hpp"
+
+// Differential fuzz target: every classification path has to give the verdict of the byte-at-a-time
+// reference built on a frozen copy of the original Sequence classes, whatever the input and however it is cut
+// into blocks or chunks.
+// Built with clang it is a libFuzzer target:  file_fuzz [libFuzzer options] CORPUS_DIRECTORY test_files
+// Otherwise it is a standalone driver that runs the exhaustive GB 18030 and UTF-16 edge cases, then every
+// seed file and random mutations of them:  file_fuzz [--iterations N] [FILES | DIRECTORIES]
+
+namespace {
+    using Bytes = std::vector<std::uint8_t>;
+    using File::FileType;
+
+    // splitmix64, so a failing input always replays with the same splits.
+    class Random {
+        std::uint64_t m_state;
+
+    public:
+        explicit Random(const std::uint64_t seed) noexcept : m_state{seed} { }
+
+        std::uint64_t next() noexcept {
+            std::uint64_t value{m_state += 0x9E3779B97F4A7C15};
+            value = (value ^ value >> 30) * 0xBF58476D1CE4E5B9;
+            value = (value ^ value >> 27) * 0x94D049BB133111EB;
+            return value ^ value >> 31;
+        }
+
+        std::size_t below(const std::size_t bound) noexcept {
+            return bound == 0 ? 0 : static_cast<std::size_t>(next() % bound);
+        }
+    };
+
+    std::uint64_t hash(const std::span<const std::uint8_t> bytes) noexcept {
+        std::uint64_t value{0xCBF29CE484222325};
+        for (const std::uint8_t byte: bytes) {
+            value = (value ^ byte) * 0x100000001B3;
+        }
+        return value;
+    }
+
+    // The classifier as it was before any of the fast paths, built on the frozen baseline sequences: one byte at
+    // a time through validateVle.
+    FileType reference(const std::span<const std::uint8_t> bytes) {
+        using namespace File::Baseline;
+        bool isAscii{true}, isLatin1{true}, isUtf8{true}, isUtf16{true}, isGb{true};
+        std::optional<Utf8Sequence> utf8Sequence{std::nullopt};
+        std::optional<Utf16Sequence> utf16Sequence{std::nullopt};
+        std::optional<GbSequence> gbSequence{std::nullopt};
+        std::optional<File::Unicode::Endianness> endianness{std::nullopt};
+        std::array<std::uint8_t, 2> byteBuffer{0, 0};
+        std::uint64_t bytesRead{0};
+        for (const std::uint8_t byte: bytes) {
+            bytesRead++;
+            if (isAscii && !isByteAscii(byte)) {
+                isAscii = false;
+            }
+            if (!isAscii && isUtf16) {
+                byteBuffer[(bytesRead - 1) % 2] = byte;
+                if (bytesRead % 2 == 0) {
+                    const auto bigEndian{static_cast<std::uint16_t>(byteBuffer[0] << 8 | byteBuffer[1])};
+                    const auto littleEndian{static_cast<std::uint16_t>(byteBuffer[1] << 8 | byteBuffer[0])};
+                    if (endianness.has_value()) {
+                        validateVle<std::uint16_t, Utf16Sequence>(
+                            isUtf16, utf16Sequence,
+                            endianness == File::Unicode::Endianness::bigEndian ? bigEndian : littleEndian);
+                    } else if (bigEndian == 0xFEFF) {
+                        endianness = File::Unicode::Endianness::bigEndian;
+                    } else if (littleEndian == 0xFEFF) {
+                        endianness = File::Unicode::Endianness::littleEndian;
+                    } else {
+                        isUtf16 = false;
+                    }
+                }
+            }
+            if (!isAscii && isUtf8) {
+                validateVle<std::uint8_t, Utf8Sequence>(isUtf8, utf8Sequence, byte);
+            }
+            if (!isAscii && isGb) {
+                validateVle<std::uint8_t, GbSequence>(isGb, gbSequence, byte);
+            }
+            if (!isAscii && isLatin1 && !isByteLatin1(byte)) {
+                isLatin1 = false;
+            }
+            if (!isAscii && !isUtf16 && !isUtf8 && !isGb && !isLatin1) {
+                return FileType::data;
+            }
+        }
+        if (isAscii) {
+            return FileType::ascii;
+        }
+        if (isUtf16 && !utf16Sequence.has_value()) {
+            return FileType::utf16;
+        }
+        if (isUtf8 && !utf8Sequence.has_value()) {
+            return FileType::utf8;
+        }
+        if (isLatin1) {
+            return FileType::latin1;
+        }
+        if (isGb && !gbSequence.has_value()) {
+            return FileType::gb;
+        }
+        return FileType::data;
+    }
+
+    // Whether the whole stream is a run of complete sequences, checked with a baseline Sequence class alone.
+    template<class Sequence>
+    bool isValidSequence(const std::span<const std::uint8_t> bytes) {
+        bool isValid{true};
+        std::optional<Sequence> sequence{};
+        for (const std::uint8_t byte: bytes) {
+            File::Baseline::validateVle<std::uint8_t, Sequence>(isValid, sequence, byte);
+            if (!isValid) {
+                return false;
+            }
+        }
+        return !sequence.has_value();
+    }
+
+    // Block boundaries for one way of cutting size bytes: each entry is a block length.
+    std::vector<std::size_t> randomSplits(const std::size_t size, Random& random, const std::size_t evenTo = 1) {
+        std::vector<std::size_t> lengths{};
+        const std::size_t largest{std::max<std::size_t>(size / 4, 8)};
+        for (std::size_t offset = 0; offset < size;) {
+            std::size_t length{1 + random.below(random.below(4) == 0 ? 8 : largest)};
+            length += (evenTo - length % evenTo) % evenTo;
+            length = std::min(length, size - offset);
+            lengths.push_back(length);
+            offset += length;
+        }
+        return lengths;
+    }
+
+    [[noreturn]] void mismatch(const std::string_view path, const std::span<const std::uint8_t> bytes,
+                               const std::string_view expected, const std::string_view actual) {
+        std::cerr << "Mismatch in " << path << ": expected " << expected << ", got " << actual << "\nInput ("
+                  << bytes.size() << " bytes):";
+        constexpr char digits[]{"0123456789abcdef"};
+        for (std::size_t i = 0; i < std::min<std::size_t>(bytes.size(), 4096); i++) {
+            std::cerr << (i % 32 == 0 ? "\n" : " ") << digits[bytes[i] >> 4] << digits[bytes[i] & 15];
+        }
+        std::cerr << std::endl;
+        std::abort();
+    }
+
+    void expectType(const std::string_view path, const std::span<const std::uint8_t> bytes, const FileType expected,
+                    const FileType actual) {
+        if (expected != actual) {
+            mismatch(path, bytes, std::to_string(static_cast<int>(expected)), std::to_string(static_cast<int>(actual)));
+        }
+    }
+
+    void expectBool(const std::string_view path, const std::span<const std::uint8_t> bytes, const bool expected,
+                    const bool actual) {
+        if (expected != actual) {
+            mismatch(path, bytes, expected ? "valid" : "invalid", actual ? "valid" : "invalid");
+        }
+    }
+
+    FileType classify(const std::span<const std::uint8_t> bytes, const std::span<const std::size_t> lengths) {
+        File::Classifier classifier{};
+        std::size_t offset{0};
+        for (const std::size_t length: lengths) {
+            classifier.feed(bytes.subspan(offset, length));
+            offset += length;
+        }
+        return classifier.finish();
+    }
+
+    // The chunk-parallel path: chunks summarised independently against the head, then appended in order.
+    FileType summarize(const std::span<const std::uint8_t> bytes, const std::span<const std::size_t> lengths) {
+        File::ChunkSummary whole{File::ChunkSummary::summarize(bytes.first(lengths.front()))};
+        const File::ChunkSummary head{whole};
+        std::size_t offset{lengths.front()};
+        for (const std::size_t length: lengths.subspan(1)) {
+            whole.append(File::ChunkSummary::summarize(bytes.subspan(offset, length), head));
+            offset += length;
+        }
+        return whole.verdict();
+    }
+
+    // Sequence::consume over the blocks, which must agree with validateVle one byte at a time.
+    template<class Sequence>
+    bool consumeSequences(const std::span<const std::uint8_t> bytes, const std::span<const std::size_t> lengths) {
+        std::optional<Sequence> pending{};
+        std::size_t offset{0};
+        for (const std::size_t length: lengths) {
+            if (!Sequence::consume(pending, bytes.subspan(offset, length))) {
+                return false;
+            }
+            offset += length;
+        }
+        return !pending.has_value();
+    }
+
+    template<class Validator>
+    bool validate(Validator validator, const std::span<const std::uint8_t> bytes,
+                  const std::span<const std::size_t> lengths) {
+        std::size_t offset{0};
+        for (const std::size_t length: lengths) {
+            if (!validator.consume(bytes.subspan(offset, length))) {
+                return false;
+            }
+            offset += length;
+        }
+        return validator.isValid();
+    }
+
+    void check(const std::span<const std::uint8_t> bytes) {
+        if (bytes.empty()) {
+            return;
+        }
+        const FileType expected{reference(bytes)};
+        const bool isUtf8{isValidSequence<File::Baseline::Utf8Sequence>(bytes)};
+        const bool isGb{isValidSequence<File::Baseline::GbSequence>(bytes)};
+        std::size_t asciiPrefix{0};
+        while (asciiPrefix < bytes.size() && File::Latin1::isAsciiText(bytes[asciiPrefix])) {
+            asciiPrefix++;
+        }
+
+        std::vector<std::vector<std::size_t>> splits{{bytes.size()}};
+        std::vector<std::vector<std::size_t>> evenSplits{{bytes.size()}};
+        if (bytes.size() <= 4096) {
+            splits.emplace_back(bytes.size(), 1);
+            evenSplits.emplace_back(bytes.size() / 2, 2);
+            if (bytes.size() % 2 != 0) {
+                evenSplits.back().push_back(1);
+            }
+        }
+        Random random{hash(bytes)};
+        for (int i = 0; i < 3; i++) {
+            splits.push_back(randomSplits(bytes.size(), random));
+            evenSplits.push_back(randomSplits(bytes.size(), random, 2));
+        }
+
+        for (const std::vector<std::size_t>& lengths: splits) {
+            expectType("Classifier", bytes, expected, classify(bytes, lengths));
+            expectBool("GbValidator", bytes, isGb, validate(File::GbValidator{}, bytes, lengths));
+            expectBool("GbSequence::consume", bytes, isGb, consumeSequences<File::GbSequence>(bytes, lengths));
+            expectBool("Utf8Sequence::consume", bytes, isUtf8,
+                       consumeSequences<File::Unicode::Utf8Sequence>(bytes, lengths));
+        }
+        for (const std::vector<std::size_t>& lengths: evenSplits) {
+            expectType("ChunkSummary", bytes, expected, summarize(bytes, lengths));
+        }
+        std::uint8_t possible{File::Simd::ByteClass::all};
+        for (const std::uint8_t byte: bytes) {
+            possible &= File::Simd::byteClasses[byte];
+        }
+        const std::array<std::size_t, 1> whole{bytes.size()};
+        const bool isUtf16{validate(File::Unicode::Utf16Validator{File::Simd::Isa::scalar}, bytes, whole)};
+        constexpr File::Simd::Isa isas[]{
+            File::Simd::Isa::scalar, File::Simd::Isa::sse2, File::Simd::Isa::avx2, File::Simd::Isa::avx512
+        };
+        for (const File::Simd::Isa requested: isas) {
+            const File::Simd::Isa isa{File::Simd::supportedIsa(requested)};
+            if (isa != requested) {
+                continue;
+            }
+            if (File::Simd::asciiTextPrefix(bytes, isa) != asciiPrefix) {
+                mismatch("asciiTextPrefix", bytes, std::to_string(asciiPrefix),
+                         std::to_string(File::Simd::asciiTextPrefix(bytes, isa)));
+            }
+            if (File::Simd::possibleClasses(bytes, File::Simd::ByteClass::all, isa) != possible) {
+                mismatch("possibleClasses", bytes, std::to_string(possible),
+                         std::to_string(File::Simd::possibleClasses(bytes, File::Simd::ByteClass::all, isa)));
+            }
+            for (const std::vector<std::size_t>& lengths: splits) {
+                expectBool("Utf8Validator", bytes, isUtf8,
+                           validate(File::Unicode::Utf8Validator{isa}, bytes, lengths));
+                expectBool("GbValidator", bytes, isGb, validate(File::GbValidator{isa}, bytes, lengths));
+                expectBool("Utf16Validator", bytes, isUtf16,
+                           validate(File::Unicode::Utf16Validator{isa}, bytes, lengths));
+            }
+        }
+    }
+
+    // Runs fn on every input in the cross product of the byte choices for each position.
+    template<typename Function>
+    void crossProduct(const std::span<const std::vector<std::uint8_t>> choices, Bytes& bytes, Function&& function) {
+        if (bytes.size() == choices.size()) {
+            function(std::span<const std::uint8_t>{bytes});
+            return;
+        }
+        for (const std::uint8_t byte: choices[bytes.size()]) {
+            bytes.push_back(byte);
+            crossProduct(choices, bytes, function);
+            bytes.pop_back();
+        }
+    }
+
+    // Checks bytes alone and with ASCII text around it, which moves it to odd offsets and past the ASCII prefix.
+    void checkInContext(const std::span<const std::uint8_t> bytes) {
+        check(bytes);
+        Bytes framed{'a'};
+        framed.insert(framed.end(), bytes.begin(), bytes.end());
+        check(framed);
+        framed.push_back('b');
+        check(std::span{framed}.subspan(1));
+    }
+
+    std::vector<std::uint8_t> allBytes() {
+        std::vector<std::uint8_t> bytes(256);
+        for (std::size_t i = 0; i < bytes.size(); i++) {
+            bytes[i] = static_cast<std::uint8_t>(i);
+        }
+        return bytes;
+    }
+
+    void checkGbEdgeCases() {
+        // Every two-byte input, then four-byte sequences over the boundaries of each byte's range.
+        const std::vector all{allBytes()};
+        const std::vector<std::uint8_t> leads{0x7F, 0x80, 0x81, 0x84, 0x85, 0x8F, 0x90, 0xA1, 0xE3, 0xE4, 0xFE, 0xFF};
+        const std::vector<std::uint8_t> digits{0x2F, 0x30, 0x39, 0x3A, 0x40, 0x7F, 0x80, 0xFE};
+        const std::vector<std::uint8_t> thirds{0x30, 0x80, 0x81, 0x82, 0xFD, 0xFE, 0xFF};
+        Bytes bytes{};
+        const std::vector twoBytes{all, all};
+        crossProduct(std::span{twoBytes}, bytes, checkInContext);
+        const std::vector fourBytes{leads, digits, thirds, digits};
+        crossProduct(std::span{fourBytes}, bytes, checkInContext);
+        // Every two-byte input again, just before and straddling a 64-byte block of the vector kernel.
+        for (const std::size_t offset: {62, 63}) {
+            for (std::size_t pair = 0; pair < 256 * 256; pair++) {
+                Bytes padded{};
+                for (std::size_t i = 0; i + 1 < offset; i += 2) {
+                    padded.insert(padded.end(), {0xB0, 0xA1});
+                }
+                padded.resize(offset, 'a');
+                padded.insert(padded.end(), {static_cast<std::uint8_t>(pair >> 8), static_cast<std::uint8_t>(pair)});
+                padded.resize(offset + 66, 'a');
+                check(padded);
+            }
+        }
+    }
+
+    void checkUtf16EdgeCases() {
+        // Code units around the surrogate ranges, the text boundaries and the byte order marks.
+        constexpr std::uint16_t units[]{
+            0x0000, 0x0009, 0x001F, 0x0020, 0x007F, 0x0080, 0x009F, 0x00A0, 0x00FF, 0x0100, 0xD7FF, 0xD800,
+            0xDBFF, 0xDC00, 0xDFFF, 0xE000, 0xFEFF, 0xFFFE, 0xFFFF
+        };
+        for (const bool isBigEndian: {true, false}) {
+            const auto encode{
+                [isBigEndian](Bytes& bytes, const std::uint16_t unit) {
+                    const auto high{static_cast<std::uint8_t>(unit >> 8)};
+                    const auto low{static_cast<std::uint8_t>(unit)};
+                    bytes.push_back(isBigEndian ? high : low);
+                    bytes.push_back(isBigEndian ? low : high);
+                }
+            };
+            for (const std::uint16_t first: units) {
+                for (const std::uint16_t second: units) {
+                    for (const std::uint16_t third: units) {
+                        Bytes bytes{};
+                        encode(bytes, 0xFEFF);
+                        encode(bytes, first);
+                        encode(bytes, second);
+                        encode(bytes, third);
+                        for (std::size_t length = 3; length <= bytes.size(); length++) {
+                            checkInContext(std::span{bytes}.first(length));
+                        }
+                        // The same units straddling a 64-byte block of the vector kernel.
+                        Bytes padded{};
+                        encode(padded, 0xFEFF);
+                        for (int i = 0; i < 30; i++) {
+                            encode(padded, 'a');
+                        }
+                        padded.insert(padded.end(), bytes.begin() + 2, bytes.end());
+                        while (padded.size() < 130) {
+                            encode(padded, 'a');
+                        }
+                        checkInContext(padded);
+                    }
+                }
+            }
+        }
+    }
+
+    Bytes mutate(Bytes bytes, Random& random) {
+        const std::size_t mutations{1 + random.below(8)};
+        for (std::size_t i = 0; i < mutations; i++) {
+            const std::size_t position{random.below(bytes.size() + 1)};
+            switch (random.below(5)) {
+                case 0:
+                    if (position < bytes.size()) {
+                        bytes[position] = static_cast<std::uint8_t>(random.next());
+                    }
+                    break;
+                case 1:
+                    bytes.insert(bytes.begin() + static_cast<std::ptrdiff_t>(position),
+                                 static_cast<std::uint8_t>(random.next()));
+                    break;
+                case 2:
+                    if (position < bytes.size()) {
+                        bytes.erase(bytes.begin() + static_cast<std::ptrdiff_t>(position));
+                    }
+                    break;
+                case 3:
+                    bytes.resize(position);
+                    break;
+                default:
+                    // High bytes are where the encodings disagree, so they are worth more than uniform noise.
+                    bytes.insert(bytes.begin() + static_cast<std::ptrdiff_t>(position),
+                                 static_cast<std::uint8_t>(0x80 | random.next()));
+                    break;
+            }
+        }
+        return bytes;
+    }
+
+    std::optional<Bytes> readFile(const std::filesystem::path& path) {
+        std::ifstream stream{path, std::ios::binary};
+        if (!stream.is_open()) {
+            return std::nullopt;
+        }
+        return Bytes{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    }
+}
+
+#ifdef FILE_LIBFUZZER
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, const std::size_t size) {
+    check(std::span{data, size});
+    return 0;
+}
+#else
+int main(const int argc, char* argv[]) {
+    std::size_t iterations{1000};
+    std::vector<std::filesystem::path> seeds{};
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument{argv[i]};
+        if (argument == "--iterations" && i + 1 < argc) {
+            iterations = std::stoul(argv[++i]);
+        } else if (std::filesystem::is_directory(argument)) {
+            for (const std::filesystem::directory_entry& entry: std::filesystem::directory_iterator{argument}) {
+                if (entry.is_regular_file()) {
+                    seeds.push_back(entry.path());
+                }
+            }
+        } else {
+            seeds.emplace_back(argument);
+        }
+    }
+    std::ranges::sort(seeds);
+
+    checkGbEdgeCases();
+    std::cout << "GB 18030 edge cases passed" << std::endl;
+    checkUtf16EdgeCases();
+    std::cout << "UTF-16 edge cases passed" << std::endl;
+
+    Random random{0x66696C65};
+    for (const std::filesystem::path& path: seeds) {
+        std::optional bytes{readFile(path)};
+        if (!bytes.has_value()) {
+            std::cerr << "Unable to read " << path << std::endl;
+            return EXIT_FAILURE;
+        }
+        check(*bytes);
+        // Mutating a short window keeps each input small, so splits down to single bytes are still tried.
+        for (std::size_t i = 0; i < iterations; i++) {
+            const std::size_t start{random.below(bytes->size())};
+            const std::size_t length{std::min(bytes->size() - start, 1 + random.below(512))};
+            check(mutate(Bytes{bytes->begin() + static_cast<std::ptrdiff_t>(start),
+                               bytes->begin() + static_cast<std::ptrdiff_t>(start + length)}, random));
+        }
+        std::cout << path.filename().string() << " passed" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,126 @@
+#include "ChunkSummary.hpp"
+#include "Metrics.hpp"
+#include "simd/Ascii.hpp"
+#include "simd/ByteClass.hpp"
+
+namespace File {
+    namespace {
+        constexpr std::size_t asciiWindow{64};
+    }
+
+    ChunkSummary::ChunkSummary() noexcept : m_isAscii{true}, m_isLatin1{true} { }
+
+    ChunkSummary ChunkSummary::summarize(const std::span<const std::uint8_t> chunk, const bool isLatin1,
+                                         const std::span<const Unicode::Utf8Validator::State> utf8Entries,
+                                         const std::span<const Unicode::Utf16Validator::State> utf16Entries,
+                                         const std::span<const GbValidator::State> gbEntries) {
+        ChunkSummary summary{};
+        const std::size_t asciiLength{Simd::asciiTextPrefix(chunk)};
+        summary.m_isAscii = asciiLength == chunk.size();
+        summary.m_isLatin1 = isLatin1 &&
+                             Simd::possibleClasses(chunk.subspan(asciiLength), Simd::ByteClass::latin1) != 0;
+        std::span scanned{chunk};
+        if (summary.m_isAscii && chunk.size() > asciiWindow) {
+            // After this many ASCII bytes every open sequence has been rejected and the surviving states
+            // only alternate with the byte parity, so an even-length rest of ASCII maps each onto itself.
+            scanned = chunk.first(asciiWindow + chunk.size() % 2);
+        }
+        summary.m_utf8 = Transfer<Unicode::Utf8Validator>::compute(scanned, utf8Entries);
+        summary.m_utf16 = Transfer<Unicode::Utf16Validator>::compute(scanned, utf16Entries);
+        summary.m_gb = Transfer<GbValidator>::compute(scanned, gbEntries);
+        if (Metrics::isEnabled()) {
+            // Every entry state of a tracked encoding is run over the ASCII prefix too.
+            Metrics::addScanned(Metrics::Candidate::ascii, std::min(asciiLength + 1, chunk.size()));
+            Metrics::addScanned(Metrics::Candidate::latin1, isLatin1 ? chunk.size() - asciiLength : 0);
+            Metrics::addScanned(Metrics::Candidate::utf8, utf8Entries.empty() ? 0 : scanned.size());
+            Metrics::addScanned(Metrics::Candidate::utf16, utf16Entries.empty() ? 0 : scanned.size());
+            Metrics::addScanned(Metrics::Candidate::gb, gbEntries.empty() ? 0 : scanned.size());
+        }
+        return summary;
+    }
+
+    ChunkSummary ChunkSummary::summarize(const std::span<const std::uint8_t> chunk) {
+        static constexpr std::array utf8Entries{Unicode::Utf8Validator::accept};
+        static constexpr std::array<Unicode::Utf16Validator::State, 1> utf16Entries{
+            Unicode::Utf16Validator::asciiEven
+        };
+        static constexpr std::array gbEntries{GbValidator::start};
+        return summarize(chunk, true, utf8Entries, utf16Entries, gbEntries);
+    }
+
+    ChunkSummary ChunkSummary::summarize(const std::span<const std::uint8_t> chunk, const ChunkSummary& head) {
+        using Unicode::Utf16Validator;
+        using Unicode::Utf8Validator;
+        std::span<const Utf8Validator::State> utf8Entries{Utf8Validator::states};
+        if (head.m_utf8.apply(Utf8Validator::accept) == Utf8Validator::reject) {
+            utf8Entries = {};
+        }
+        // Once the byte order mark has been seen every later unit is decoded with the same endianness.
+        static constexpr std::array<Utf16Validator::State, 2> bigEntries{
+            Utf16Validator::bigStart, Utf16Validator::bigPending
+        };
+        static constexpr std::array<Utf16Validator::State, 2> littleEntries{
+            Utf16Validator::littleStart, Utf16Validator::littlePending
+        };
+        const Utf16Validator::State utf16Head{head.m_utf16.apply(Utf16Validator::asciiEven)};
+        std::span<const Utf16Validator::State> utf16Entries{Utf16Validator::evenStates};
+        if (utf16Head == Utf16Validator::reject) {
+            utf16Entries = {};
+        } else if (utf16Head >= Utf16Validator::bigStart && utf16Head <= Utf16Validator::bigPendingAfterLow) {
+            utf16Entries = bigEntries;
+        } else if (utf16Head >= Utf16Validator::littleStart) {
+            utf16Entries = littleEntries;
+        }
+        std::span<const GbValidator::State> gbEntries{GbValidator::states};
+        if (head.m_gb.apply(GbValidator::start) == GbValidator::reject) {
+            gbEntries = {};
+        }
+        return summarize(chunk, head.m_isLatin1, utf8Entries, utf16Entries, gbEntries);
+    }
+
+    ChunkSummary& ChunkSummary::append(const ChunkSummary& next) noexcept {
+        m_isAscii = m_isAscii && next.m_isAscii;
+        m_isLatin1 = m_isLatin1 && next.m_isLatin1;
+        m_utf8 = m_utf8.then(next.m_utf8);
+        m_utf16 = m_utf16.then(next.m_utf16);
+        m_gb = m_gb.then(next.m_gb);
+        return *this;
+    }
+
+    ChunkSummary& ChunkSummary::appendAfterGap(const ChunkSummary& next) noexcept {
+        m_isAscii = m_isAscii && next.m_isAscii;
+        m_isLatin1 = m_isLatin1 && next.m_isLatin1;
+        m_utf8 = m_utf8.thenAfterGap(next.m_utf8);
+        m_utf16 = m_utf16.thenAfterGap(next.m_utf16);
+        m_gb = m_gb.thenAfterGap(next.m_gb);
+        return *this;
+    }
+
+    std::array<bool, 5> ChunkSummary::candidates() const noexcept {
+        return {
+            m_isAscii,
+            m_utf16.apply(Unicode::Utf16Validator::asciiEven) != Unicode::Utf16Validator::reject,
+            m_utf8.apply(Unicode::Utf8Validator::accept) != Unicode::Utf8Validator::reject,
+            m_isLatin1,
+            m_gb.apply(GbValidator::start) != GbValidator::reject
+        };
+    }
+
+    bool ChunkSummary::hasCandidates() const noexcept {
+        return std::ranges::any_of(candidates(), [](const bool isCandidate) { return isCandidate; });
+    }
+
+    FileType ChunkSummary::verdict() const noexcept {
+        return preferredType(
+            m_isAscii,
+            Unicode::Utf16Validator::isAccepting(m_utf16.apply(Unicode::Utf16Validator::asciiEven)),
+            Unicode::Utf8Validator::isAccepting(m_utf8.apply(Unicode::Utf8Validator::accept)),
+            m_isLatin1,
+            GbValidator::isAccepting(m_gb.apply(GbValidator::start)));
+    }
+
+    FileType ChunkSummary::provisionalVerdict() const noexcept {
+        const auto [isAscii, isUtf16, isUtf8, isLatin1, isGb]{candidates()};
+        return preferredType(isAscii, isUtf16, isUtf8, isLatin1, isGb);
+    }
+} // File
@@ -0,0 +1,159 @@
+#ifndef CHUNKSUMMARY_HPP
+#define CHUNKSUMMARY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "FileType.hpp"
+#include "vle/GbValidator.hpp"
+#include "vle/unicode/Utf16Validator.hpp"
+#include "vle/unicode/Utf8Validator.hpp"
+
+namespace File {
+    // Maps every state a validator can enter a chunk in to the state it leaves the chunk in.
+    template<class Validator>
+    class Transfer {
+    public:
+        using State = typename Validator::State;
+        static constexpr std::size_t stateCount{Validator::states.size()};
+
+    private:
+        std::array<State, stateCount> m_exits;
+
+        static constexpr std::size_t indexOf(const State state) noexcept {
+            return static_cast<std::size_t>(
+                std::ranges::find(Validator::states, state) - Validator::states.begin());
+        }
+
+    public:
+        constexpr Transfer() noexcept : m_exits{Validator::states} { }
+
+        // Runs every entry state over bytes in lockstep. Tracks that meet are merged and tracks that
+        // reject are dropped, so once the chunk has synchronised a single validator finishes the rest.
+        [[nodiscard]] static Transfer compute(std::span<const std::uint8_t> bytes,
+                                              const std::span<const State> entries) noexcept {
+            constexpr std::size_t stride{64};
+            Transfer transfer{};
+            transfer.m_exits.fill(Validator::reject);
+            std::array<State, stateCount> tracks{};
+            std::array<std::size_t, stateCount> trackOf{};
+            std::size_t trackCount{0};
+            for (std::size_t i = 0; i < entries.size(); i++) {
+                trackOf[i] = trackCount;
+                tracks[trackCount++] = entries[i];
+            }
+            while (trackCount > 1 && !bytes.empty()) {
+                const std::size_t length{std::min(bytes.size(), stride)};
+                for (const std::uint8_t byte: bytes.first(length)) {
+                    for (std::size_t track = 0; track < trackCount; track++) {
+                        tracks[track] = Validator::step(tracks[track], byte);
+                    }
+                }
+                bytes = bytes.subspan(length);
+                std::array<std::size_t, stateCount> remap{};
+                std::size_t merged{0};
+                for (std::size_t track = 0; track < trackCount; track++) {
+                    if (tracks[track] == Validator::reject) {
+                        remap[track] = stateCount;
+                        continue;
+                    }
+                    const auto* found{std::find(tracks.begin(), tracks.begin() + merged, tracks[track])};
+                    remap[track] = static_cast<std::size_t>(found - tracks.begin());
+                    if (remap[track] == merged) {
+                        tracks[merged++] = tracks[track];
+                    }
+                }
+                for (std::size_t i = 0; i < entries.size(); i++) {
+                    trackOf[i] = trackOf[i] == stateCount ? stateCount : remap[trackOf[i]];
+                }
+                trackCount = merged;
+            }
+            if (trackCount == 1 && !bytes.empty()) {
+                Validator validator{};
+                validator.resume(tracks[0]);
+                validator.consume(bytes);
+                tracks[0] = validator.state();
+            }
+            for (std::size_t i = 0; i < entries.size(); i++) {
+                if (trackOf[i] < trackCount) {
+                    transfer.m_exits[indexOf(entries[i])] = tracks[trackOf[i]];
+                }
+            }
+            return transfer;
+        }
+
+        [[nodiscard]] constexpr State apply(const State entry) const noexcept {
+            return m_exits[indexOf(entry)];
+        }
+
+        // The transfer of this chunk followed directly by next.
+        [[nodiscard]] constexpr Transfer then(const Transfer& next) const noexcept {
+            Transfer combined{};
+            for (std::size_t i = 0; i < stateCount; i++) {
+                combined.m_exits[i] = next.apply(m_exits[i]);
+            }
+            return combined;
+        }
+
+        // The transfer of this chunk followed by next with unread bytes in between. The bytes in between
+        // could have left next in any of its entry states, so any state next can exit in will do.
+        [[nodiscard]] constexpr Transfer thenAfterGap(const Transfer& next) const noexcept {
+            const auto survivor{std::ranges::find_if(next.m_exits, [](const State state) {
+                return state != Validator::reject;
+            })};
+            Transfer combined{};
+            for (std::size_t i = 0; i < stateCount; i++) {
+                combined.m_exits[i] = m_exits[i] == Validator::reject || survivor == next.m_exits.end()
+                                          ? static_cast<State>(Validator::reject)
+                                          : *survivor;
+            }
+            return combined;
+        }
+    };
+
+    // Everything classification needs to know about one chunk of a file, independent of its neighbours.
+    class ChunkSummary {
+        bool m_isAscii;
+        bool m_isLatin1;
+        Transfer<Unicode::Utf8Validator> m_utf8;
+        Transfer<Unicode::Utf16Validator> m_utf16;
+        Transfer<GbValidator> m_gb;
+
+        [[nodiscard]] static ChunkSummary summarize(std::span<const std::uint8_t> chunk, bool isLatin1,
+                                                    std::span<const Unicode::Utf8Validator::State> utf8Entries,
+                                                    std::span<const Unicode::Utf16Validator::State> utf16Entries,
+                                                    std::span<const GbValidator::State> gbEntries);
+
+    public:
+        // An empty chunk, the identity for append.
+        ChunkSummary() noexcept;
+
+        // Summarises the chunk a file starts with, which is only ever entered in the initial states.
+        [[nodiscard]] static ChunkSummary summarize(std::span<const std::uint8_t> chunk);
+
+        // Summarises a chunk lying anywhere after head, skipping the encodings head already rules out.
+        // Chunks have to start at even offsets, where UTF-16 code units begin.
+        [[nodiscard]] static ChunkSummary summarize(std::span<const std::uint8_t> chunk, const ChunkSummary& head);
+
+        ChunkSummary& append(const ChunkSummary& next) noexcept;
+
+        // Appends a chunk that does not directly follow this one, as when sampling windows of a file.
+        ChunkSummary& appendAfterGap(const ChunkSummary& next) noexcept;
+
+        // The encodings the bytes summarised have not ruled out, in the order preferredType takes them.
+        [[nodiscard]] std::array<bool, 5> candidates() const noexcept;
+
+        // Whether more bytes could still make some encoding other than data the verdict.
+        [[nodiscard]] bool hasCandidates() const noexcept;
+
+        [[nodiscard]] FileType verdict() const noexcept;
+
+        // The verdict if the file went on validly past the bytes summarised, so a sequence left open at
+        // the end does not count against its encoding.
+        [[nodiscard]] FileType provisionalVerdict() const noexcept;
+    };
+} // File
+
+#endif //CHUNKSUMMARY_HPP
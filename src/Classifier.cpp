@@ -0,0 +1,36 @@
+#include "Classifier.hpp"
+#include "Metrics.hpp"
+
+namespace File {
+    namespace Detail {
+        void recordClassifierMetrics(const std::uint64_t offset, const std::size_t length,
+                                     const std::size_t asciiLength, const std::array<bool, 5>& wasCandidate,
+                                     const std::array<bool, 5>& isCandidate) noexcept {
+            if (!Metrics::isEnabled()) {
+                return;
+            }
+            for (std::size_t i = 0; i < isCandidate.size(); i++) {
+                if (!wasCandidate[i]) {
+                    continue;
+                }
+                const auto candidate{static_cast<Metrics::Candidate>(i)};
+                // ASCII is checked up to the first byte outside it; the others only see what follows.
+                const bool isAsciiCandidate{candidate == Metrics::Candidate::ascii};
+                const std::size_t examined{
+                    isAsciiCandidate ? std::min(asciiLength + 1, length) : length - asciiLength
+                };
+                Metrics::addScanned(candidate, examined);
+                if (!isCandidate[i]) {
+                    Metrics::addElimination(candidate, offset + (isAsciiCandidate ? asciiLength : length));
+                }
+            }
+        }
+    }
+
+    template class BasicClassifier<FileType::ascii, FileType::utf16, FileType::utf8, FileType::latin1, FileType::gb>;
+    template class BasicClassifier<FileType::ascii>;
+    template class BasicClassifier<FileType::ascii, FileType::utf8>;
+    template class BasicClassifier<FileType::ascii, FileType::utf16, FileType::utf8>;
+    template class BasicClassifier<FileType::ascii, FileType::utf8, FileType::latin1>;
+    template class BasicClassifier<FileType::ascii, FileType::utf8, FileType::gb>;
+} // File
@@ -0,0 +1,206 @@
+#ifndef CLASSIFIER_HPP
+#define CLASSIFIER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "FileType.hpp"
+#include "simd/Ascii.hpp"
+#include "simd/ByteClass.hpp"
+#include "vle/GbValidator.hpp"
+#include "vle/unicode/Utf16Validator.hpp"
+#include "vle/unicode/Utf8Validator.hpp"
+
+namespace File {
+    namespace Detail {
+        // Stands in for the validator of an encoding that was not asked for.
+        struct Unused { };
+
+        // Candidates in the order preferredType takes them: ASCII, UTF-16, UTF-8, ISO-8859-1, GB 18030.
+        void recordClassifierMetrics(std::uint64_t offset, std::size_t length, std::size_t asciiLength,
+                                     const std::array<bool, 5>& wasCandidate,
+                                     const std::array<bool, 5>& isCandidate) noexcept;
+    }
+
+    // Resumable classifier: bytes may arrive in blocks of any size and the verdict is the same as if the
+    // whole stream had been seen at once. Blocks are only read during feed and never retained.
+    // Only the encodings in the pack can be the verdict; the others are never validated and take no space.
+    template<FileType... Encodings>
+    class BasicClassifier {
+        static constexpr bool has(const FileType type) noexcept {
+            return ((Encodings == type) || ...);
+        }
+
+        static_assert(((Encodings != FileType::empty && Encodings != FileType::data) && ...),
+                      "Only text encodings can be classified");
+
+        static constexpr bool hasAscii{has(FileType::ascii)};
+        static constexpr bool hasUtf16{has(FileType::utf16)};
+        static constexpr bool hasUtf8{has(FileType::utf8)};
+        static constexpr bool hasLatin1{has(FileType::latin1)};
+        static constexpr bool hasGb{has(FileType::gb)};
+
+        // The ASCII prefix is tracked whatever the pack: every other encoding skips over it.
+        bool m_isAscii;
+        bool m_isLatin1;
+        bool m_isUtf8;
+        bool m_isUtf16;
+        bool m_isGb;
+        std::uint64_t m_bytesFed;
+        std::uint64_t m_bytesScanned;
+        [[no_unique_address]] std::conditional_t<hasUtf8, Unicode::Utf8Validator, Detail::Unused> m_utf8;
+        [[no_unique_address]] std::conditional_t<hasUtf16, Unicode::Utf16Validator, Detail::Unused> m_utf16;
+        [[no_unique_address]] std::conditional_t<hasGb, GbValidator, Detail::Unused> m_gb;
+
+        [[nodiscard]] constexpr std::array<bool, 5> candidates() const noexcept {
+            return {hasAscii && m_isAscii, m_isUtf16, m_isUtf8, m_isLatin1, m_isGb};
+        }
+
+        // Without ASCII in the pack, pure ASCII text goes to the first ASCII-compatible encoding; UTF-16
+        // only counts once a byte order mark has started decoding.
+        [[nodiscard]] constexpr FileType verdict(bool isUtf16, bool isUtf8, bool isGb) const noexcept {
+            return preferredType(hasAscii && m_isAscii, isUtf16 && !m_isAscii, isUtf8, m_isLatin1, isGb);
+        }
+
+    public:
+        static constexpr std::size_t blockSize{256 * 1024};
+
+        BasicClassifier() noexcept : m_isAscii{true},
+                                     m_isLatin1{hasLatin1},
+                                     m_isUtf8{hasUtf8},
+                                     m_isUtf16{hasUtf16},
+                                     m_isGb{hasGb},
+                                     m_bytesFed{0},
+                                     m_bytesScanned{0},
+                                     m_utf8{},
+                                     m_utf16{},
+                                     m_gb{} { }
+
+        void feed(const std::span<const std::byte> bytes) noexcept {
+            feed(std::span{reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size()});
+        }
+
+        void feed(std::span<const std::uint8_t> bytes) noexcept;
+
+        // Whether no further input can change the verdict, so feeding can stop early.
+        [[nodiscard]] bool isDecided() const noexcept {
+            return !m_isAscii && !m_isUtf16 && !m_isUtf8 && !m_isGb && !m_isLatin1;
+        }
+
+        [[nodiscard]] std::uint64_t bytesFed() const noexcept {
+            return m_bytesFed;
+        }
+
+        // Bytes actually examined, which falls short of bytesFed when the verdict was decided mid-block.
+        [[nodiscard]] std::uint64_t bytesScanned() const noexcept {
+            return m_bytesScanned;
+        }
+
+        [[nodiscard]] FileType finish() const noexcept;
+
+        // The verdict if the stream went on validly past the bytes fed so far, for when only a prefix is
+        // read. A sequence left open at the end does not count against its encoding.
+        [[nodiscard]] FileType provisional() const noexcept {
+            return m_bytesFed == 0 ? FileType::empty : verdict(m_isUtf16, m_isUtf8, m_isGb);
+        }
+
+        void reset() noexcept {
+            *this = BasicClassifier{};
+        }
+    };
+
+    template<FileType... Encodings>
+    void BasicClassifier<Encodings...>::feed(std::span<const std::uint8_t> bytes) noexcept {
+        m_bytesFed += bytes.size();
+        // Large blocks are walked in slices so every validator works on data that is still in cache and
+        // a decided verdict stops the scan early.
+        while (!bytes.empty() && !isDecided()) {
+            const std::span part{bytes.first(std::min(bytes.size(), blockSize))};
+            bytes = bytes.subspan(part.size());
+            const std::array wasCandidate{candidates()};
+            std::size_t asciiLength{0};
+            if (m_isAscii) {
+                asciiLength = Simd::asciiTextPrefix(part);
+                m_isAscii = asciiLength == part.size();
+                if constexpr (hasUtf16) {
+                    m_utf16.skipAsciiText(asciiLength);
+                }
+            }
+            const std::span remaining{part.subspan(asciiLength)};
+            // One pass rules out every candidate holding a byte it never accepts before any decoder runs.
+            // ISO-8859-1 has no state, so this is its whole check.
+            if constexpr (hasLatin1 || hasUtf8 || hasGb) {
+                const auto candidates{
+                    static_cast<std::uint8_t>((m_isLatin1 ? Simd::ByteClass::latin1 : 0) |
+                                              (m_isUtf8 ? Simd::ByteClass::utf8 : 0) |
+                                              (m_isGb ? Simd::ByteClass::gb : 0))
+                };
+                if (candidates != 0) {
+                    const std::uint8_t possible{Simd::possibleClasses(remaining, candidates)};
+                    m_isLatin1 = (possible & Simd::ByteClass::latin1) != 0;
+                    m_isUtf8 = (possible & Simd::ByteClass::utf8) != 0;
+                    m_isGb = (possible & Simd::ByteClass::gb) != 0;
+                }
+            }
+            if constexpr (hasUtf16) {
+                if (m_isUtf16) {
+                    m_isUtf16 = m_utf16.consume(remaining);
+                }
+            }
+            if constexpr (hasUtf8) {
+                if (m_isUtf8) {
+                    m_isUtf8 = m_utf8.consume(remaining);
+                }
+            }
+            if constexpr (hasGb) {
+                if (m_isGb) {
+                    m_isGb = m_gb.consume(remaining);
+                }
+            }
+            Detail::recordClassifierMetrics(m_bytesScanned, part.size(), asciiLength, wasCandidate, candidates());
+            m_bytesScanned += part.size();
+        }
+    }
+
+    template<FileType... Encodings>
+    FileType BasicClassifier<Encodings...>::finish() const noexcept {
+        if (m_bytesFed == 0) {
+            return FileType::empty;
+        }
+        bool isUtf16{m_isUtf16};
+        bool isUtf8{m_isUtf8};
+        bool isGb{m_isGb};
+        if constexpr (hasUtf16) {
+            isUtf16 = isUtf16 && m_utf16.isValid();
+        }
+        if constexpr (hasUtf8) {
+            isUtf8 = isUtf8 && m_utf8.isValid();
+        }
+        if constexpr (hasGb) {
+            isGb = isGb && m_gb.isValid();
+        }
+        return verdict(isUtf16, isUtf8, isGb);
+    }
+
+    // Every encoding; the other instantiations below are the narrower sets the command line offers.
+    using Classifier = BasicClassifier<FileType::ascii, FileType::utf16, FileType::utf8, FileType::latin1,
+        FileType::gb>;
+    using AsciiClassifier = BasicClassifier<FileType::ascii>;
+    using Utf8Classifier = BasicClassifier<FileType::ascii, FileType::utf8>;
+    using UnicodeClassifier = BasicClassifier<FileType::ascii, FileType::utf16, FileType::utf8>;
+    using WesternClassifier = BasicClassifier<FileType::ascii, FileType::utf8, FileType::latin1>;
+    using ChineseClassifier = BasicClassifier<FileType::ascii, FileType::utf8, FileType::gb>;
+
+    extern template class BasicClassifier<FileType::ascii, FileType::utf16, FileType::utf8, FileType::latin1,
+        FileType::gb>;
+    extern template class BasicClassifier<FileType::ascii>;
+    extern template class BasicClassifier<FileType::ascii, FileType::utf8>;
+    extern template class BasicClassifier<FileType::ascii, FileType::utf16, FileType::utf8>;
+    extern template class BasicClassifier<FileType::ascii, FileType::utf8, FileType::latin1>;
+    extern template class BasicClassifier<FileType::ascii, FileType::utf8, FileType::gb>;
+} // File
+
+#endif //CLASSIFIER_HPP
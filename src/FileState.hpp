@@ -0,0 +1,20 @@
+#ifndef FILESTATE_HPP
+#define FILESTATE_HPP
+
+#include <cstdint>
+#include <variant>
+#include "FileType.hpp"
+
+namespace File {
+    enum class FileError : std::uint8_t {
+        metadataError,
+        doesNotExist,
+        invalidPerms,
+        notRegularFile,
+        unreadable,
+    };
+
+    using FileState = std::variant<FileType, FileError>;
+} // File
+
+#endif //FILESTATE_HPP
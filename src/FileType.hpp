@@ -0,0 +1,39 @@
+#ifndef FILETYPE_HPP
+#define FILETYPE_HPP
+
+#include <cstdint>
+
+namespace File {
+    enum class FileType: std::uint8_t {
+        empty,
+        ascii,
+        latin1,
+        utf8,
+        utf16,
+        gb,
+        data
+    };
+
+    // Picks the verdict for the encodings that survived a whole file, in order of preference.
+    [[nodiscard]] constexpr FileType preferredType(const bool isAscii, const bool isUtf16, const bool isUtf8,
+                                                   const bool isLatin1, const bool isGb) noexcept {
+        if (isAscii) {
+            return FileType::ascii;
+        }
+        if (isUtf16) {
+            return FileType::utf16;
+        }
+        if (isUtf8) {
+            return FileType::utf8;
+        }
+        if (isLatin1) {
+            return FileType::latin1;
+        }
+        if (isGb) {
+            return FileType::gb;
+        }
+        return FileType::data;
+    }
+} // File
+
+#endif //FILETYPE_HPP
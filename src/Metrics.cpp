@@ -0,0 +1,173 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <time.h>
+
+namespace File {
+    namespace {
+        using Counter = std::atomic<std::uint64_t>;
+
+        struct PhaseCounters {
+            Counter count;
+            Counter wallNanos;
+            Counter cpuNanos;
+        };
+
+        struct CandidateCounters {
+            Counter bytesScanned;
+            Counter eliminations;
+            Counter eliminationOffsetTotal;
+            Counter eliminationOffsetMaximum;
+        };
+
+        // One per thread that ever recorded anything; kept after the thread exits so its counts still add up.
+        struct alignas(64) Slot {
+            std::array<PhaseCounters, Metrics::phaseCount> phases{};
+            std::array<CandidateCounters, Metrics::candidateCount> candidates{};
+            Counter filesClassified{0};
+            Counter earlyExits{0};
+            Counter lockWaits{0};
+            Counter lockWaitNanos{0};
+        };
+
+        std::atomic<bool> isRecording{false};
+        std::mutex slotsMutex{};
+        std::vector<std::unique_ptr<Slot>> slots{};
+        thread_local Slot* currentSlot{nullptr};
+
+        Slot& localSlot() {
+            if (currentSlot == nullptr) {
+                std::lock_guard guard{slotsMutex};
+                currentSlot = slots.emplace_back(std::make_unique<Slot>()).get();
+            }
+            return *currentSlot;
+        }
+
+        // Only the owning thread writes a counter, so a plain load and store is enough.
+        void add(Counter& counter, const std::uint64_t value) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        std::uint64_t nanosSince(const std::chrono::steady_clock::time_point start) noexcept {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    Metrics::Timer::Timer(const Phase phase) noexcept : m_phase{phase},
+                                                        m_isActive{isEnabled()},
+                                                        m_wallStart{},
+                                                        m_cpuStart{0} {
+        if (m_isActive) {
+            m_wallStart = std::chrono::steady_clock::now();
+            m_cpuStart = threadCpuNanos();
+        }
+    }
+
+    Metrics::Timer::~Timer() {
+        if (!m_isActive) {
+            return;
+        }
+        PhaseCounters& counters{localSlot().phases[static_cast<std::size_t>(m_phase)]};
+        add(counters.count, 1);
+        add(counters.wallNanos, nanosSince(m_wallStart));
+        add(counters.cpuNanos, threadCpuNanos() - m_cpuStart);
+    }
+
+    void Metrics::enable() noexcept {
+        isRecording.store(true, std::memory_order_relaxed);
+    }
+
+    bool Metrics::isEnabled() noexcept {
+        return isRecording.load(std::memory_order_relaxed);
+    }
+
+    void Metrics::addElapsed(const Phase phase, const std::chrono::steady_clock::time_point start) noexcept {
+        if (!isEnabled()) {
+            return;
+        }
+        PhaseCounters& counters{localSlot().phases[static_cast<std::size_t>(phase)]};
+        add(counters.count, 1);
+        add(counters.wallNanos, nanosSince(start));
+    }
+
+    void Metrics::addScanned(const Candidate candidate, const std::uint64_t bytes) noexcept {
+        if (isEnabled()) {
+            add(localSlot().candidates[static_cast<std::size_t>(candidate)].bytesScanned, bytes);
+        }
+    }
+
+    void Metrics::addElimination(const Candidate candidate, const std::uint64_t offset) noexcept {
+        if (!isEnabled()) {
+            return;
+        }
+        CandidateCounters& counters{localSlot().candidates[static_cast<std::size_t>(candidate)]};
+        add(counters.eliminations, 1);
+        add(counters.eliminationOffsetTotal, offset);
+        if (offset > counters.eliminationOffsetMaximum.load(std::memory_order_relaxed)) {
+            counters.eliminationOffsetMaximum.store(offset, std::memory_order_relaxed);
+        }
+    }
+
+    void Metrics::addClassified(const bool isEarlyExit) noexcept {
+        if (!isEnabled()) {
+            return;
+        }
+        Slot& slot{localSlot()};
+        add(slot.filesClassified, 1);
+        add(slot.earlyExits, isEarlyExit ? 1 : 0);
+    }
+
+    std::unique_lock<std::mutex> Metrics::lock(std::mutex& mutex) {
+        std::unique_lock lock{mutex, std::try_to_lock};
+        if (lock.owns_lock()) {
+            return lock;
+        }
+        if (!isEnabled()) {
+            lock.lock();
+            return lock;
+        }
+        const std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+        lock.lock();
+        Slot& slot{localSlot()};
+        add(slot.lockWaits, 1);
+        add(slot.lockWaitNanos, nanosSince(start));
+        return lock;
+    }
+
+    Metrics::Snapshot Metrics::snapshot() {
+        Snapshot snapshot{};
+        std::lock_guard guard{slotsMutex};
+        snapshot.threads = slots.size();
+        for (const std::unique_ptr<Slot>& slot: slots) {
+            for (std::size_t i = 0; i < phaseCount; i++) {
+                snapshot.phases[i].count += slot->phases[i].count.load(std::memory_order_relaxed);
+                snapshot.phases[i].wallNanos += slot->phases[i].wallNanos.load(std::memory_order_relaxed);
+                snapshot.phases[i].cpuNanos += slot->phases[i].cpuNanos.load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < candidateCount; i++) {
+                const CandidateCounters& counters{slot->candidates[i]};
+                CandidateTotals& totals{snapshot.candidates[i]};
+                totals.bytesScanned += counters.bytesScanned.load(std::memory_order_relaxed);
+                totals.eliminations += counters.eliminations.load(std::memory_order_relaxed);
+                totals.eliminationOffsetTotal += counters.eliminationOffsetTotal.load(std::memory_order_relaxed);
+                totals.eliminationOffsetMaximum = std::max(totals.eliminationOffsetMaximum,
+                                                           counters.eliminationOffsetMaximum.load(
+                                                               std::memory_order_relaxed));
+            }
+            snapshot.filesClassified += slot->filesClassified.load(std::memory_order_relaxed);
+            snapshot.earlyExits += slot->earlyExits.load(std::memory_order_relaxed);
+            snapshot.lockWaits += slot->lockWaits.load(std::memory_order_relaxed);
+            snapshot.lockWaitNanos += slot->lockWaitNanos.load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    std::uint64_t Metrics::threadCpuNanos() noexcept {
+        timespec time{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return static_cast<std::uint64_t>(time.tv_sec) * 1'000'000'000 + static_cast<std::uint64_t>(time.tv_nsec);
+    }
+} // File
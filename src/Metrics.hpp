@@ -0,0 +1,106 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace File {
+    // Process-wide counters behind --stats. Every thread writes only its own slot, with relaxed loads and
+    // stores rather than read-modify-write instructions, and a snapshot sums the slots while threads run.
+    // Nothing is recorded until enable is called, so a disabled recorder costs one relaxed load per call.
+    class Metrics {
+    public:
+        enum class Phase : std::uint8_t {
+            deduplicate,
+            metadata,
+            open,
+            scan,
+            cache,
+            output,
+            // Producer time spent waiting for room in the pool or the reorder window.
+            backpressure,
+            phaseCount
+        };
+
+        // Indexed like the arguments of preferredType.
+        enum class Candidate : std::uint8_t {
+            ascii,
+            utf16,
+            utf8,
+            latin1,
+            gb,
+            candidateCount
+        };
+
+        static constexpr std::size_t phaseCount{static_cast<std::size_t>(Phase::phaseCount)};
+        static constexpr std::size_t candidateCount{static_cast<std::size_t>(Candidate::candidateCount)};
+
+        struct PhaseTotals {
+            std::uint64_t count;
+            std::uint64_t wallNanos;
+            std::uint64_t cpuNanos;
+        };
+
+        struct CandidateTotals {
+            std::uint64_t bytesScanned;
+            std::uint64_t eliminations;
+            // Offsets into the file at which the candidate was ruled out, to the end of the block examined.
+            std::uint64_t eliminationOffsetTotal;
+            std::uint64_t eliminationOffsetMaximum;
+        };
+
+        struct Snapshot {
+            std::array<PhaseTotals, phaseCount> phases;
+            std::array<CandidateTotals, candidateCount> candidates;
+            std::uint64_t filesClassified;
+            std::uint64_t earlyExits;
+            std::uint64_t lockWaits;
+            std::uint64_t lockWaitNanos;
+            std::size_t threads;
+        };
+
+        // Times one phase on the current thread, in wall-clock and thread CPU time.
+        class Timer {
+            Phase m_phase;
+            bool m_isActive;
+            std::chrono::steady_clock::time_point m_wallStart;
+            std::uint64_t m_cpuStart;
+
+        public:
+            explicit Timer(Phase phase) noexcept;
+
+            Timer(const Timer&) = delete;
+
+            Timer& operator=(const Timer&) = delete;
+
+            ~Timer();
+        };
+
+        static void enable() noexcept;
+
+        [[nodiscard]] static bool isEnabled() noexcept;
+
+        // Counts one run of phase since start that the kernel carried out, as an asynchronous operation does,
+        // in wall-clock time only.
+        static void addElapsed(Phase phase, std::chrono::steady_clock::time_point start) noexcept;
+
+        static void addScanned(Candidate candidate, std::uint64_t bytes) noexcept;
+
+        static void addElimination(Candidate candidate, std::uint64_t offset) noexcept;
+
+        // Counts a classified file; an early exit is a verdict reached with part of the file never examined.
+        static void addClassified(bool isEarlyExit) noexcept;
+
+        // Locks mutex, timing the wait when it is already held by another thread.
+        [[nodiscard]] static std::unique_lock<std::mutex> lock(std::mutex& mutex);
+
+        [[nodiscard]] static Snapshot snapshot();
+
+        [[nodiscard]] static std::uint64_t threadCpuNanos() noexcept;
+    };
+} // File
+
+#endif //METRICS_HPP
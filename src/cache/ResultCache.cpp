@@ -0,0 +1,228 @@
+#include "ResultCache.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <tuple>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../Metrics.hpp"
+
+namespace File {
+    namespace {
+        constexpr char magic[8]{'F', 'I', 'L', 'E', 'C', 'A', 'C', '1'};
+        constexpr std::uint8_t emptyTag{0};
+        constexpr std::uint8_t busyTag{0xFF};
+
+        std::uint64_t hashOf(const ResultCache::Key& key) noexcept {
+            std::uint64_t hash{key.inode * 0x9E3779B97F4A7C15 ^ key.device};
+            hash ^= std::rotl(key.size * 0xC2B2AE3D27D4EB4F, 31) ^ static_cast<std::uint64_t>(key.modified);
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCD;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        constexpr std::size_t fileSize(const std::uint64_t capacity, const std::size_t header,
+                                       const std::size_t slot) noexcept {
+            return header + capacity * slot;
+        }
+    }
+
+    ResultCache::ResultCache(const int descriptor, std::filesystem::path path) noexcept : m_descriptor{descriptor},
+        m_path{std::move(path)},
+        m_header{nullptr},
+        m_slots{nullptr},
+        m_mask{0},
+        m_inserted{0},
+        m_dropped{0} { }
+
+    ResultCache::ResultCache(ResultCache&& other) noexcept : m_descriptor{other.m_descriptor},
+                                                             m_path{std::move(other.m_path)},
+                                                             m_header{other.m_header},
+                                                             m_slots{other.m_slots},
+                                                             m_mask{other.m_mask},
+                                                             m_inserted{other.m_inserted.load()},
+                                                             m_dropped{other.m_dropped.load()} {
+        other.m_descriptor = -1;
+        other.m_header = nullptr;
+        other.m_slots = nullptr;
+    }
+
+    ResultCache::~ResultCache() {
+        if (m_header != nullptr) {
+            if (m_inserted.load() != 0 || m_dropped.load() != 0) {
+                compact();
+            }
+            unmap();
+        }
+        if (m_descriptor >= 0) {
+            close(m_descriptor);
+        }
+    }
+
+    std::optional<ResultCache> ResultCache::open(const std::filesystem::path& path) noexcept {
+        while (true) {
+            const int descriptor{::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)};
+            if (descriptor < 0) {
+                return std::nullopt;
+            }
+            // Waiting for another process could mean waiting for as long as a daemon runs, so a cache in
+            // use is reported instead and the caller goes on without it.
+            int locked;
+            do {
+                locked = flock(descriptor, LOCK_EX | LOCK_NB);
+            } while (locked != 0 && errno == EINTR);
+            if (locked != 0) {
+                const int error{errno};
+                close(descriptor);
+                errno = error;
+                return std::nullopt;
+            }
+            ResultCache cache{descriptor, path};
+            struct stat opened{};
+            struct stat current{};
+            if (fstat(descriptor, &opened) != 0) {
+                return std::nullopt;
+            }
+            // The process that held the lock may have replaced the file while compacting it.
+            if (stat(path.c_str(), &current) != 0 || current.st_ino != opened.st_ino ||
+                current.st_dev != opened.st_dev) {
+                continue;
+            }
+            Header header{};
+            const bool isValid{
+                static_cast<std::size_t>(opened.st_size) >= sizeof(Header) &&
+                pread(descriptor, &header, sizeof(Header), 0) == sizeof(Header) &&
+                std::memcmp(header.magic, magic, sizeof(magic)) == 0 &&
+                header.capacity >= minimumCapacity && std::has_single_bit(header.capacity) &&
+                static_cast<std::size_t>(opened.st_size) == fileSize(header.capacity, sizeof(Header), sizeof(Slot))
+            };
+            if (!cache.map(isValid ? header.capacity : minimumCapacity, !isValid)) {
+                return std::nullopt;
+            }
+            return std::make_optional<ResultCache>(std::move(cache));
+        }
+    }
+
+    bool ResultCache::map(const std::uint64_t capacity, const bool isNew) noexcept {
+        const std::size_t size{fileSize(capacity, sizeof(Header), sizeof(Slot))};
+        if (isNew && (ftruncate(m_descriptor, 0) != 0 || ftruncate(m_descriptor, static_cast<off_t>(size)) != 0)) {
+            return false;
+        }
+        void* mapping{mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_descriptor, 0)};
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        m_header = static_cast<Header*>(mapping);
+        m_slots = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + sizeof(Header));
+        m_mask = capacity - 1;
+        if (isNew) {
+            std::memcpy(m_header->magic, magic, sizeof(magic));
+            m_header->capacity = capacity;
+            m_header->count = 0;
+        }
+        return true;
+    }
+
+    void ResultCache::unmap() noexcept {
+        munmap(m_header, fileSize(m_mask + 1, sizeof(Header), sizeof(Slot)));
+        m_header = nullptr;
+        m_slots = nullptr;
+    }
+
+    void ResultCache::compact() noexcept {
+        std::vector<Slot> live{};
+        try {
+            live.reserve(std::atomic_ref{m_header->count}.load());
+            for (std::uint64_t i = 0; i <= m_mask; i++) {
+                if (m_slots[i].tag != emptyTag && m_slots[i].tag != busyTag) {
+                    live.push_back(m_slots[i]);
+                }
+            }
+        } catch (const std::bad_alloc&) {
+            return;
+        }
+        // Only the newest entry for each file can still match it.
+        std::ranges::sort(live, [](const Slot& a, const Slot& b) {
+            return std::tie(a.key.device, a.key.inode, b.key.modified, b.key.size) <
+                   std::tie(b.key.device, b.key.inode, a.key.modified, a.key.size);
+        });
+        const auto stale{
+            std::ranges::unique(live, [](const Slot& a, const Slot& b) {
+                return a.key.device == b.key.device && a.key.inode == b.key.inode;
+            })
+        };
+        live.erase(stale.begin(), stale.end());
+        std::uint64_t capacity{minimumCapacity};
+        while (capacity < (live.size() + m_dropped.load()) * 2) {
+            capacity <<= 1;
+        }
+        std::filesystem::path compacted{m_path};
+        compacted += ".compact";
+        const int descriptor{::open(compacted.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+        if (descriptor < 0) {
+            return;
+        }
+        ResultCache target{descriptor, compacted};
+        if (!target.map(capacity, true)) {
+            unlink(compacted.c_str());
+            return;
+        }
+        for (const Slot& slot: live) {
+            std::uint64_t i{hashOf(slot.key) & target.m_mask};
+            while (target.m_slots[i].tag != emptyTag) {
+                i = (i + 1) & target.m_mask;
+            }
+            target.m_slots[i] = slot;
+        }
+        target.m_header->count = live.size();
+        if (rename(compacted.c_str(), m_path.c_str()) != 0) {
+            unlink(compacted.c_str());
+        }
+    }
+
+    std::optional<FileType> ResultCache::find(const Key& key) const noexcept {
+        const Metrics::Timer timer{Metrics::Phase::cache};
+        std::uint64_t i{hashOf(key) & m_mask};
+        for (std::uint64_t probes = 0; probes <= m_mask; probes++, i = (i + 1) & m_mask) {
+            const std::uint8_t tag{std::atomic_ref{m_slots[i].tag}.load(std::memory_order_acquire)};
+            if (tag == emptyTag) {
+                return std::nullopt;
+            }
+            if (tag != busyTag && m_slots[i].key == key) {
+                return static_cast<FileType>(tag - 1);
+            }
+        }
+        return std::nullopt;
+    }
+
+    void ResultCache::insert(const Key& key, const FileType type) noexcept {
+        const Metrics::Timer timer{Metrics::Phase::cache};
+        std::atomic_ref count{m_header->count};
+        // Past three quarters full, probe sequences grow long enough to cost more than they save.
+        if (count.load(std::memory_order_relaxed) >= (m_mask + 1) / 4 * 3) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::uint64_t i{hashOf(key) & m_mask};
+        for (std::uint64_t probes = 0; probes <= m_mask; probes++, i = (i + 1) & m_mask) {
+            std::atomic_ref tag{m_slots[i].tag};
+            std::uint8_t expected{emptyTag};
+            if (tag.compare_exchange_strong(expected, busyTag, std::memory_order_acquire)) {
+                m_slots[i].key = key;
+                tag.store(static_cast<std::uint8_t>(static_cast<std::uint8_t>(type) + 1), std::memory_order_release);
+                count.fetch_add(1, std::memory_order_relaxed);
+                m_inserted.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (expected != busyTag && m_slots[i].key == key) {
+                return;
+            }
+        }
+    }
+} // File
@@ -0,0 +1,80 @@
+#ifndef RESULTCACHE_HPP
+#define RESULTCACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include "../FileType.hpp"
+
+namespace File {
+    // Verdicts of earlier runs, kept in a file that is mapped and used as an open-addressing hash table.
+    // Slots only ever go from empty to filled while the file is open, so lookups need no locks; a file
+    // that changed gets a new key, and the entries it leaves behind are dropped when the cache is closed.
+    class ResultCache {
+    public:
+        struct Key {
+            std::uint64_t device;
+            std::uint64_t inode;
+            std::uint64_t size;
+            std::int64_t modified;
+
+            bool operator==(const Key&) const noexcept = default;
+        };
+
+    private:
+        struct Slot {
+            Key key;
+            std::uint8_t tag;
+        };
+
+        struct Header {
+            char magic[8];
+            std::uint64_t capacity;
+            std::uint64_t count;
+        };
+
+        int m_descriptor;
+        std::filesystem::path m_path;
+        Header* m_header;
+        Slot* m_slots;
+        std::uint64_t m_mask;
+        std::atomic<std::uint64_t> m_inserted;
+        std::atomic<std::uint64_t> m_dropped;
+
+        ResultCache(int descriptor, std::filesystem::path path) noexcept;
+
+        [[nodiscard]] bool map(std::uint64_t capacity, bool isNew) noexcept;
+
+        void unmap() noexcept;
+
+        void compact() noexcept;
+
+    public:
+        static constexpr std::uint64_t minimumCapacity{1 << 16};
+
+        // Opens or creates the cache. Only one process can use it at a time; while another does, this fails
+        // with errno set to EWOULDBLOCK.
+        [[nodiscard]] static std::optional<ResultCache> open(const std::filesystem::path& path) noexcept;
+
+        ResultCache(const ResultCache&) = delete;
+
+        ResultCache(ResultCache&& other) noexcept;
+
+        ResultCache& operator=(const ResultCache&) = delete;
+
+        ResultCache& operator=(ResultCache&&) = delete;
+
+        // Rewrites the file without stale entries if anything was added, then closes it.
+        ~ResultCache();
+
+        [[nodiscard]] std::optional<FileType> find(const Key& key) const noexcept;
+
+        // Records a verdict; it is silently dropped once the table is too full, and the table is grown to
+        // fit when the cache is closed.
+        void insert(const Key& key, FileType type) noexcept;
+    };
+} // File
+
+#endif //RESULTCACHE_HPP
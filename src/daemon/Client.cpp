@@ -0,0 +1,145 @@
+#include "Client.hpp"
+#include <cerrno>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace File::Daemon {
+    Client::Client(const int descriptor) noexcept : m_descriptor{descriptor},
+                                                    m_answerPosition{0},
+                                                    m_outstanding{0} { }
+
+    Client::Client(Client&& other) noexcept : m_descriptor{other.m_descriptor},
+                                              m_requests{std::move(other.m_requests)},
+                                              m_answers{std::move(other.m_answers)},
+                                              m_answerPosition{other.m_answerPosition},
+                                              m_outstanding{other.m_outstanding} {
+        other.m_descriptor = -1;
+    }
+
+    Client::~Client() {
+        if (m_descriptor >= 0) {
+            close(m_descriptor);
+        }
+    }
+
+    std::optional<Client> Client::connect(const std::filesystem::path& socket) noexcept {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socket.native().size() >= sizeof(address.sun_path)) {
+            return std::nullopt;
+        }
+        socket.native().copy(address.sun_path, sizeof(address.sun_path) - 1);
+        const int descriptor{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        Client client{descriptor};
+        if (::connect(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            return std::nullopt;
+        }
+        return std::make_optional<Client>(std::move(client));
+    }
+
+    void Client::queue(const RequestKind kind, const std::span<const std::uint8_t> payload) {
+        // The server drops the connection over a longer one, failing every other request pipelined with it.
+        if (payload.size() > maximumPayload) {
+            throw std::length_error("Request payload exceeds the daemon's limit. ");
+        }
+        const std::size_t offset{m_requests.size()};
+        m_requests.resize(offset + headerSize);
+        encodeHeader(m_requests.data() + offset, static_cast<std::uint32_t>(payload.size()), kind);
+        m_requests.insert(m_requests.end(), payload.begin(), payload.end());
+        m_outstanding++;
+    }
+
+    void Client::queuePath(const std::string_view path) {
+        queue(RequestKind::path, {reinterpret_cast<const std::uint8_t*>(path.data()), path.size()});
+    }
+
+    void Client::queueBytes(const std::span<const std::uint8_t> bytes) {
+        queue(RequestKind::bytes, bytes);
+    }
+
+    bool Client::flush() noexcept {
+        // The server stops reading requests while its answers go unread, so once both directions' socket
+        // buffers are full the answers have to be collected here or neither side ever moves again.
+        std::span<const std::uint8_t> pending{m_requests};
+        while (!pending.empty()) {
+            pollfd event{m_descriptor, POLLIN | POLLOUT, 0};
+            if (poll(&event, 1, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if ((event.revents & POLLIN) != 0 && !collect(MSG_DONTWAIT)) {
+                return false;
+            }
+            if ((event.revents & (POLLOUT | POLLERR | POLLHUP)) == 0) {
+                continue;
+            }
+            const ssize_t count{send(m_descriptor, pending.data(), pending.size(), MSG_NOSIGNAL | MSG_DONTWAIT)};
+            if (count < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            pending = pending.subspan(static_cast<std::size_t>(count));
+        }
+        m_requests.clear();
+        return true;
+    }
+
+    bool Client::collect(const int flags) noexcept {
+        if (m_answerPosition == m_answers.size()) {
+            m_answers.clear();
+            m_answerPosition = 0;
+        }
+        const std::size_t buffered{m_answers.size() - m_answerPosition};
+        if (m_outstanding == buffered) {
+            return true;
+        }
+        const std::size_t offset{m_answers.size()};
+        m_answers.resize(offset + (m_outstanding - buffered));
+        ssize_t count;
+        do {
+            count = recv(m_descriptor, m_answers.data() + offset, m_answers.size() - offset, flags);
+        } while (count < 0 && errno == EINTR);
+        if (count < 0 && flags == MSG_DONTWAIT && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            count = 0;
+        } else if (count <= 0) {
+            m_answers.resize(offset);
+            return false;
+        }
+        m_answers.resize(offset + static_cast<std::size_t>(count));
+        return true;
+    }
+
+    std::optional<FileState> Client::receive() noexcept {
+        if (m_outstanding == 0 || (m_answerPosition == m_answers.size() && !collect(0))) {
+            return std::nullopt;
+        }
+        m_outstanding--;
+        return decodeAnswer(m_answers[m_answerPosition++]);
+    }
+
+    std::optional<FileState> Client::classifyPath(const std::string_view path) {
+        queuePath(path);
+        if (!flush()) {
+            return std::nullopt;
+        }
+        return receive();
+    }
+
+    std::optional<FileState> Client::classifyBytes(const std::span<const std::uint8_t> bytes) {
+        queueBytes(bytes);
+        if (!flush()) {
+            return std::nullopt;
+        }
+        return receive();
+    }
+} // File::Daemon
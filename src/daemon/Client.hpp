@@ -0,0 +1,64 @@
+#ifndef CLIENT_HPP
+#define CLIENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "../FileState.hpp"
+#include "Protocol.hpp"
+
+namespace File::Daemon {
+    // Talks to a server started with file --daemon. Requests are queued locally and sent together by
+    // flush, which also collects the answers that arrive meanwhile; they are then received one by one in the
+    // same order.
+    class Client {
+        int m_descriptor;
+        std::vector<std::uint8_t> m_requests;
+        std::vector<std::uint8_t> m_answers;
+        std::size_t m_answerPosition;
+        std::size_t m_outstanding;
+
+        explicit Client(int descriptor) noexcept;
+
+        void queue(RequestKind kind, std::span<const std::uint8_t> payload);
+
+        // Appends answers that have arrived, up to the number still owed, to m_answers. With MSG_DONTWAIT it
+        // does not wait for any; false if the connection failed.
+        [[nodiscard]] bool collect(int flags) noexcept;
+
+    public:
+        [[nodiscard]] static std::optional<Client> connect(const std::filesystem::path& socket) noexcept;
+
+        Client(const Client&) = delete;
+
+        Client(Client&& other) noexcept;
+
+        Client& operator=(const Client&) = delete;
+
+        Client& operator=(Client&&) = delete;
+
+        ~Client();
+
+        // Both, like the classify calls, throw std::length_error and queue nothing for a payload over
+        // maximumPayload.
+        void queuePath(std::string_view path);
+
+        void queueBytes(std::span<const std::uint8_t> bytes);
+
+        // Sends every queued request; false if the connection failed.
+        [[nodiscard]] bool flush() noexcept;
+
+        // The answer to the oldest request not yet answered, or std::nullopt if the connection failed.
+        [[nodiscard]] std::optional<FileState> receive() noexcept;
+
+        [[nodiscard]] std::optional<FileState> classifyPath(std::string_view path);
+
+        [[nodiscard]] std::optional<FileState> classifyBytes(std::span<const std::uint8_t> bytes);
+    };
+} // File::Daemon
+
+#endif //CLIENT_HPP
@@ -0,0 +1,66 @@
+#ifndef PROTOCOL_HPP
+#define PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include "../FileState.hpp"
+
+namespace File::Daemon {
+    // A request is a 4-byte payload length and a 1-byte kind, both in host order, followed by the payload:
+    // a path, or the bytes to classify. Every request is answered by one byte, in the order requests were
+    // sent. A client can pipeline requests, but the server stops reading them while its answers go unread,
+    // so a client sending more than the socket buffers hold has to read answers while it sends.
+    enum class RequestKind : std::uint8_t {
+        path = 1,
+        bytes = 2,
+    };
+
+    constexpr std::size_t headerSize{5};
+    constexpr std::uint32_t maximumPayload{64 * 1024 * 1024};
+
+    // Answers are a FileType, a FileError with the high bit set, or malformed, after which the server
+    // closes the connection.
+    constexpr std::uint8_t errorAnswer{0x80};
+    constexpr std::uint8_t malformedAnswer{0xFF};
+
+    inline void encodeHeader(std::uint8_t* header, const std::uint32_t length, const RequestKind kind) noexcept {
+        std::memcpy(header, &length, sizeof(length));
+        header[sizeof(length)] = static_cast<std::uint8_t>(kind);
+    }
+
+    [[nodiscard]] inline std::uint32_t decodeLength(const std::uint8_t* header) noexcept {
+        std::uint32_t length;
+        std::memcpy(&length, header, sizeof(length));
+        return length;
+    }
+
+    [[nodiscard]] inline std::optional<RequestKind> decodeKind(const std::uint8_t* header) noexcept {
+        const std::uint8_t kind{header[sizeof(std::uint32_t)]};
+        if (kind != static_cast<std::uint8_t>(RequestKind::path) &&
+            kind != static_cast<std::uint8_t>(RequestKind::bytes)) {
+            return std::nullopt;
+        }
+        return static_cast<RequestKind>(kind);
+    }
+
+    [[nodiscard]] constexpr std::uint8_t encodeAnswer(const FileState& state) noexcept {
+        if (std::holds_alternative<FileType>(state)) {
+            return static_cast<std::uint8_t>(std::get<FileType>(state));
+        }
+        return errorAnswer | static_cast<std::uint8_t>(std::get<FileError>(state));
+    }
+
+    [[nodiscard]] constexpr std::optional<FileState> decodeAnswer(const std::uint8_t answer) noexcept {
+        if (answer <= static_cast<std::uint8_t>(FileType::data)) {
+            return static_cast<FileType>(answer);
+        }
+        if (answer >= errorAnswer && answer <= (errorAnswer | static_cast<std::uint8_t>(FileError::unreadable))) {
+            return static_cast<FileError>(answer & ~errorAnswer);
+        }
+        return std::nullopt;
+    }
+} // File::Daemon
+
+#endif //PROTOCOL_HPP
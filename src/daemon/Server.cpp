@@ -0,0 +1,217 @@
+#include "Server.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <latch>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace File::Daemon {
+    namespace {
+        struct Request {
+            RequestKind kind;
+            std::span<const std::uint8_t> payload;
+        };
+
+        bool sendAll(const int descriptor, std::span<const std::uint8_t> bytes) noexcept {
+            while (!bytes.empty()) {
+                const ssize_t count{send(descriptor, bytes.data(), bytes.size(), MSG_NOSIGNAL)};
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0) {
+                    return false;
+                }
+                bytes = bytes.subspan(static_cast<std::size_t>(count));
+            }
+            return true;
+        }
+
+        // Whether the socket file at address can be removed: nothing accepts connections on it any more.
+        bool isStale(const sockaddr_un& address) noexcept {
+            const int probe{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+            if (probe < 0) {
+                return false;
+            }
+            int connected;
+            do {
+                connected = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+            } while (connected != 0 && errno == EINTR);
+            const bool isRefused{connected != 0 && errno == ECONNREFUSED};
+            close(probe);
+            return isRefused;
+        }
+    }
+
+    Server::Server(const int listener, const int wakeRead, const int wakeWrite, std::filesystem::path path,
+                   WorkStealingPool& pool, Handler&& handler) noexcept : m_listener{listener},
+                                                                         m_wakeRead{wakeRead},
+                                                                         m_wakeWrite{wakeWrite},
+                                                                         m_path{std::move(path)},
+                                                                         m_pool{&pool},
+                                                                         m_handler{std::move(handler)} { }
+
+    Server::Server(Server&& other) noexcept : m_listener{other.m_listener},
+                                              m_wakeRead{other.m_wakeRead},
+                                              m_wakeWrite{other.m_wakeWrite},
+                                              m_path{std::move(other.m_path)},
+                                              m_pool{other.m_pool},
+                                              m_handler{std::move(other.m_handler)} {
+        other.m_listener = -1;
+        other.m_wakeRead = -1;
+        other.m_wakeWrite = -1;
+    }
+
+    Server::~Server() {
+        if (m_listener >= 0) {
+            close(m_listener);
+            unlink(m_path.c_str());
+        }
+        if (m_wakeRead >= 0) {
+            close(m_wakeRead);
+            close(m_wakeWrite);
+        }
+    }
+
+    std::optional<Server> Server::listen(const std::filesystem::path& path, WorkStealingPool& pool,
+                                         Handler handler) noexcept {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.native().size() >= sizeof(address.sun_path)) {
+            return std::nullopt;
+        }
+        path.native().copy(address.sun_path, sizeof(address.sun_path) - 1);
+        // A socket file that still answers belongs to a running server; bind then fails with EADDRINUSE.
+        struct stat existing{};
+        if (lstat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode) && isStale(address)) {
+            unlink(path.c_str());
+        }
+        const int listener{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        if (listener < 0) {
+            return std::nullopt;
+        }
+        int wake[2];
+        if (pipe2(wake, O_CLOEXEC | O_NONBLOCK) != 0) {
+            close(listener);
+            return std::nullopt;
+        }
+        Server server{listener, wake[0], wake[1], path, pool, std::move(handler)};
+        if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            // Nothing was bound, so there is no socket file of ours to remove.
+            close(server.m_listener);
+            server.m_listener = -1;
+            return std::nullopt;
+        }
+        if (::listen(listener, SOMAXCONN) != 0) {
+            return std::nullopt;
+        }
+        return std::make_optional<Server>(std::move(server));
+    }
+
+    void Server::run() {
+        std::array<pollfd, 2> events{{{m_listener, POLLIN, 0}, {m_wakeRead, POLLIN, 0}}};
+        while (true) {
+            if (poll(events.data(), events.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            if (events[1].revents != 0) {
+                break;
+            }
+            const int connection{accept4(m_listener, nullptr, nullptr, SOCK_CLOEXEC)};
+            if (connection < 0) {
+                continue;
+            }
+            {
+                std::lock_guard guard{m_connectionMutex};
+                m_connections.insert(connection);
+            }
+            std::thread{[this, connection] { serve(connection); }}.detach();
+        }
+        std::unique_lock lock{m_connectionMutex};
+        for (const int connection: m_connections) {
+            shutdown(connection, SHUT_RDWR);
+        }
+        m_connectionClosed.wait(lock, [this] { return m_connections.empty(); });
+    }
+
+    void Server::stop() const noexcept {
+        const char wake{0};
+        [[maybe_unused]] const ssize_t written{write(m_wakeWrite, &wake, 1)};
+    }
+
+    void Server::serve(const int connection) {
+        std::vector<std::uint8_t> buffer(readSize);
+        std::size_t filled{0};
+        std::vector<Request> batch{};
+        std::vector<std::uint8_t> answers{};
+        bool isOpen{true};
+        while (isOpen) {
+            const ssize_t count{recv(connection, buffer.data() + filled, buffer.size() - filled, 0)};
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                break;
+            }
+            filled += static_cast<std::size_t>(count);
+            batch.clear();
+            answers.clear();
+            std::size_t offset{0};
+            std::size_t needed{0};
+            while (filled - offset >= headerSize) {
+                const std::uint32_t length{decodeLength(buffer.data() + offset)};
+                const std::optional kind{decodeKind(buffer.data() + offset)};
+                if (!kind.has_value() || length > maximumPayload) {
+                    isOpen = false;
+                    break;
+                }
+                if (filled - offset < headerSize + length) {
+                    needed = headerSize + length;
+                    break;
+                }
+                batch.push_back({*kind, {buffer.data() + offset + headerSize, length}});
+                offset += headerSize + length;
+            }
+            answers.resize(batch.size());
+            if (batch.size() == 1) {
+                answers[0] = encodeAnswer(m_handler(batch[0].kind, batch[0].payload));
+            } else if (batch.size() > 1) {
+                std::latch answered{static_cast<std::ptrdiff_t>(batch.size())};
+                for (std::size_t i = 0; i < batch.size(); i++) {
+                    m_pool->submit([this, &batch, &answers, &answered, i] {
+                        answers[i] = encodeAnswer(m_handler(batch[i].kind, batch[i].payload));
+                        answered.count_down();
+                    });
+                }
+                answered.wait();
+            }
+            if (!isOpen) {
+                answers.push_back(malformedAnswer);
+            }
+            if (!sendAll(connection, answers)) {
+                break;
+            }
+            std::memmove(buffer.data(), buffer.data() + offset, filled - offset);
+            filled -= offset;
+            // Only a request larger than the usual read grows the buffer, and only until it has been answered.
+            buffer.resize(std::max(readSize, needed));
+            if (buffer.capacity() > 2 * buffer.size()) {
+                buffer.shrink_to_fit();
+            }
+        }
+        close(connection);
+        std::lock_guard guard{m_connectionMutex};
+        m_connections.erase(connection);
+        m_connectionClosed.notify_all();
+    }
+} // File::Daemon
@@ -0,0 +1,66 @@
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_set>
+#include "../FileState.hpp"
+#include "../pool/WorkStealingPool.hpp"
+#include "Protocol.hpp"
+
+namespace File::Daemon {
+    // Serves classification requests on a Unix domain socket. Each connection has a thread that reads every
+    // request that has arrived, answers the batch on the pool, and writes all its answers at once.
+    class Server {
+    public:
+        using Handler = std::function<FileState(RequestKind, std::span<const std::uint8_t>)>;
+
+    private:
+        int m_listener;
+        int m_wakeRead;
+        int m_wakeWrite;
+        std::filesystem::path m_path;
+        WorkStealingPool* m_pool;
+        Handler m_handler;
+        std::mutex m_connectionMutex;
+        std::condition_variable m_connectionClosed;
+        std::unordered_set<int> m_connections;
+
+        Server(int listener, int wakeRead, int wakeWrite, std::filesystem::path path, WorkStealingPool& pool,
+               Handler&& handler) noexcept;
+
+        void serve(int connection);
+
+    public:
+        static constexpr std::size_t readSize{64 * 1024};
+
+        // Binds the socket, replacing a stale socket file left at path by an earlier server. Fails with errno
+        // set to EADDRINUSE if a server is still listening there.
+        [[nodiscard]] static std::optional<Server> listen(const std::filesystem::path& path, WorkStealingPool& pool,
+                                                          Handler handler) noexcept;
+
+        Server(const Server&) = delete;
+
+        Server(Server&& other) noexcept;
+
+        Server& operator=(const Server&) = delete;
+
+        Server& operator=(Server&&) = delete;
+
+        ~Server();
+
+        // Accepts connections until stop is called, then waits for open connections to wind down.
+        void run();
+
+        // Only writes to a pipe, so it may be called from a signal handler.
+        void stop() const noexcept;
+    };
+} // File::Daemon
+
+#endif //SERVER_HPP
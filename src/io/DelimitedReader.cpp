@@ -0,0 +1,89 @@
+#include "DelimitedReader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace File::Io {
+    DelimitedReader::DelimitedReader(const int descriptor, const char delimiter) noexcept : m_descriptor{descriptor},
+        m_delimiter{delimiter},
+        m_position{0},
+        m_filled{0},
+        m_isFinished{false} { }
+
+    DelimitedReader::DelimitedReader(DelimitedReader&& other) noexcept : m_descriptor{other.m_descriptor},
+                                                                         m_delimiter{other.m_delimiter},
+                                                                         m_buffer{std::move(other.m_buffer)},
+                                                                         m_position{other.m_position},
+                                                                         m_filled{other.m_filled},
+                                                                         m_record{std::move(other.m_record)},
+                                                                         m_isFinished{other.m_isFinished} {
+        other.m_descriptor = -1;
+    }
+
+    DelimitedReader::~DelimitedReader() {
+        if (m_descriptor >= 0) {
+            close(m_descriptor);
+        }
+    }
+
+    std::optional<DelimitedReader> DelimitedReader::open(const std::filesystem::path& path,
+                                                         const char delimiter) noexcept {
+        const int descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        return std::make_optional<DelimitedReader>(DelimitedReader{descriptor, delimiter});
+    }
+
+    std::optional<DelimitedReader> DelimitedReader::standardInput(const char delimiter) noexcept {
+        const int descriptor{fcntl(STDIN_FILENO, F_DUPFD_CLOEXEC, 0)};
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        return std::make_optional<DelimitedReader>(DelimitedReader{descriptor, delimiter});
+    }
+
+    bool DelimitedReader::refill() {
+        if (m_buffer.empty()) {
+            m_buffer.resize(bufferSize);
+        }
+        while (true) {
+            const ssize_t count{read(m_descriptor, m_buffer.data(), m_buffer.size())};
+            if (count > 0) {
+                m_position = 0;
+                m_filled = static_cast<std::size_t>(count);
+                return true;
+            }
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            m_isFinished = true;
+            return false;
+        }
+    }
+
+    std::optional<std::string_view> DelimitedReader::next() {
+        m_record.clear();
+        while (!m_isFinished) {
+            if (m_position == m_filled && !refill()) {
+                break;
+            }
+            const auto begin{m_buffer.begin() + static_cast<std::ptrdiff_t>(m_position)};
+            const auto end{m_buffer.begin() + static_cast<std::ptrdiff_t>(m_filled)};
+            const auto delimiter{std::find(begin, end, m_delimiter)};
+            m_record.append(begin, delimiter);
+            m_position = static_cast<std::size_t>(delimiter - m_buffer.begin());
+            if (delimiter != end) {
+                m_position++;
+                if (!m_record.empty()) {
+                    return m_record;
+                }
+            }
+        }
+        if (!m_record.empty()) {
+            return m_record;
+        }
+        return std::nullopt;
+    }
+} // File::Io
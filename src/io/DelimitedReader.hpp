@@ -0,0 +1,50 @@
+#ifndef DELIMITEDREADER_HPP
+#define DELIMITEDREADER_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace File::Io {
+    // Splits a file or standard input into records on a delimiter, holding at most one read buffer and
+    // the record currently being assembled, so arbitrarily long lists are read in bounded memory.
+    class DelimitedReader {
+        int m_descriptor;
+        char m_delimiter;
+        std::vector<char> m_buffer;
+        std::size_t m_position;
+        std::size_t m_filled;
+        std::string m_record;
+        bool m_isFinished;
+
+        DelimitedReader(int descriptor, char delimiter) noexcept;
+
+        bool refill();
+
+    public:
+        static constexpr std::size_t bufferSize{64 * 1024};
+
+        [[nodiscard]] static std::optional<DelimitedReader> open(const std::filesystem::path& path,
+                                                                 char delimiter) noexcept;
+
+        [[nodiscard]] static std::optional<DelimitedReader> standardInput(char delimiter) noexcept;
+
+        DelimitedReader(const DelimitedReader&) = delete;
+
+        DelimitedReader(DelimitedReader&& other) noexcept;
+
+        DelimitedReader& operator=(const DelimitedReader&) = delete;
+
+        DelimitedReader& operator=(DelimitedReader&&) = delete;
+
+        ~DelimitedReader();
+
+        // The next non-empty record, valid until the following call, or std::nullopt once input runs out.
+        [[nodiscard]] std::optional<std::string_view> next();
+    };
+} // File::Io
+
+#endif //DELIMITEDREADER_HPP
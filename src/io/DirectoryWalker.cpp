@@ -0,0 +1,258 @@
+#include "DirectoryWalker.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace File::Io {
+    namespace {
+        struct LinuxDirent64 {
+            ino64_t d_ino;
+            off64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[];
+        };
+
+        constexpr std::size_t direntBufferSize{64 * 1024};
+
+        unsigned char typeOf(const mode_t mode) noexcept {
+            if (S_ISREG(mode)) {
+                return DT_REG;
+            }
+            if (S_ISDIR(mode)) {
+                return DT_DIR;
+            }
+            return DT_UNKNOWN;
+        }
+    }
+
+    struct DirectoryWalker::Directory {
+        struct Child {
+            std::string name;
+            unsigned char type;
+            dev_t device;
+            ino_t inode;
+        };
+
+        std::filesystem::path path;
+        int parentDescriptor{-1};
+        int descriptor{-1};
+        dev_t device{};
+        ino_t inode{};
+        int error{0};
+        bool isSkipped{false};
+        std::vector<Child> children{};
+        // Only touched by the walking thread.
+        bool isScheduled{false};
+        std::mutex mutex{};
+        std::condition_variable listed{};
+        bool isListed{false};
+
+        Directory() = default;
+
+        Directory(const Directory&) = delete;
+
+        Directory& operator=(const Directory&) = delete;
+
+        ~Directory() {
+            release();
+        }
+
+        void release() noexcept {
+            if (descriptor >= 0) {
+                close(descriptor);
+                descriptor = -1;
+            }
+            children.clear();
+            children.shrink_to_fit();
+        }
+
+        // Opens the directory relative to its parent and reads every entry with getdents64. Entries whose
+        // type the file system does not report, and links that are followed, cost one fstatat each; the
+        // former are looked up through the link when links are followed, as a reported link would be.
+        void list(const bool isFollowed, const bool isFollowingLinks, const bool isOneFileSystem,
+                  const dev_t rootDevice) noexcept {
+            const int flags{O_RDONLY | O_DIRECTORY | O_CLOEXEC | (isFollowed ? 0 : O_NOFOLLOW)};
+            descriptor = parentDescriptor >= 0
+                             ? openat(parentDescriptor, path.filename().c_str(), flags)
+                             : open(path.c_str(), flags);
+            struct stat metadata{};
+            if (descriptor < 0 || fstat(descriptor, &metadata) != 0) {
+                // A link that is not followed is simply not part of the tree.
+                error = errno == ELOOP || errno == ENOTDIR ? 0 : errno;
+                isSkipped = error == 0;
+                finish();
+                return;
+            }
+            device = metadata.st_dev;
+            inode = metadata.st_ino;
+            if (isOneFileSystem && rootDevice != 0 && device != rootDevice) {
+                isSkipped = true;
+                finish();
+                return;
+            }
+            try {
+                std::vector<char> buffer(direntBufferSize);
+                while (true) {
+                    const long count{syscall(SYS_getdents64, descriptor, buffer.data(), buffer.size())};
+                    if (count < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (count < 0) {
+                        error = errno;
+                        break;
+                    }
+                    if (count == 0) {
+                        break;
+                    }
+                    for (long offset = 0; offset < count;) {
+                        const auto* entry{reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset)};
+                        offset += entry->d_reclen;
+                        const std::string_view name{entry->d_name};
+                        if (name == "." || name == "..") {
+                            continue;
+                        }
+                        Child child{std::string{name}, entry->d_type, device, static_cast<ino_t>(entry->d_ino)};
+                        if (child.type == DT_UNKNOWN || (child.type == DT_LNK && isFollowingLinks)) {
+                            struct stat target{};
+                            if (fstatat(descriptor, child.name.c_str(), &target,
+                                        child.type == DT_LNK || isFollowingLinks ? 0 : AT_SYMLINK_NOFOLLOW) != 0) {
+                                continue;
+                            }
+                            child.type = typeOf(target.st_mode);
+                            child.device = target.st_dev;
+                            child.inode = target.st_ino;
+                        }
+                        if (child.type == DT_REG || child.type == DT_DIR) {
+                            children.emplace_back(std::move(child));
+                        }
+                    }
+                }
+                std::ranges::sort(children, {}, &Child::name);
+            } catch (const std::bad_alloc&) {
+                error = ENOMEM;
+                children.clear();
+            }
+            finish();
+        }
+
+        void finish() {
+            std::lock_guard guard{mutex};
+            isListed = true;
+            listed.notify_all();
+        }
+
+        void waitUntilListed() {
+            std::unique_lock lock{mutex};
+            listed.wait(lock, [this] { return isListed; });
+        }
+    };
+
+    DirectoryWalker::DirectoryWalker(WorkStealingPool& pool, const Follow follow,
+                                     const bool isOneFileSystem) noexcept : m_pool{pool},
+                                                                            m_follow{follow},
+                                                                            m_isOneFileSystem{isOneFileSystem},
+                                                                            m_prefetchLimit{pool.size() * 4} { }
+
+    void DirectoryWalker::walk(const std::filesystem::path& root, const Callback& onEntry, const Filter& isWalked) {
+        struct Frame {
+            std::shared_ptr<Directory> directory;
+            std::vector<std::shared_ptr<Directory>> subdirectories;
+            std::size_t child;
+            std::size_t visited;
+            std::size_t scheduled;
+        };
+        const bool isFollowingLinks{m_follow == Follow::always};
+        auto top{std::make_shared<Directory>()};
+        top->path = root;
+        top->list(m_follow != Follow::never, isFollowingLinks, false, 0);
+        if (top->error != 0) {
+            onEntry({root, 0, 0, top->error});
+            return;
+        }
+        if (isWalked) {
+            std::erase_if(top->children, [&root, &isWalked](const Directory::Child& child) {
+                return !isWalked(root / child.name);
+            });
+        }
+        const dev_t rootDevice{top->device};
+        std::vector<Frame> stack{};
+        std::size_t outstanding{0};
+        auto enter{
+            [&stack](std::shared_ptr<Directory>&& directory) {
+                Frame frame{std::move(directory), {}, 0, 0, 0};
+                for (const Directory::Child& child: frame.directory->children) {
+                    if (child.type == DT_DIR) {
+                        auto subdirectory{std::make_shared<Directory>()};
+                        subdirectory->path = frame.directory->path / child.name;
+                        subdirectory->parentDescriptor = frame.directory->descriptor;
+                        frame.subdirectories.emplace_back(std::move(subdirectory));
+                    }
+                }
+                stack.emplace_back(std::move(frame));
+            }
+        };
+        if (!top->isSkipped) {
+            enter(std::move(top));
+        }
+        while (!stack.empty()) {
+            Frame& frame{stack.back()};
+            // Directories about to be walked are listed ahead on the pool, a bounded number at a time.
+            while (frame.scheduled < frame.subdirectories.size() && outstanding < m_prefetchLimit) {
+                std::shared_ptr subdirectory{frame.subdirectories[frame.scheduled++]};
+                if (subdirectory->isScheduled) {
+                    continue;
+                }
+                subdirectory->isScheduled = true;
+                outstanding++;
+                m_pool.submit([this, subdirectory, isFollowingLinks, rootDevice] {
+                    subdirectory->list(isFollowingLinks, isFollowingLinks, m_isOneFileSystem, rootDevice);
+                });
+            }
+            if (frame.child == frame.directory->children.size()) {
+                frame.directory->release();
+                stack.pop_back();
+                continue;
+            }
+            const Directory::Child& child{frame.directory->children[frame.child++]};
+            if (child.type == DT_REG) {
+                onEntry({frame.directory->path / child.name, child.device, child.inode, 0});
+                continue;
+            }
+            std::shared_ptr subdirectory{frame.subdirectories[frame.visited++]};
+            if (subdirectory->isScheduled) {
+                subdirectory->waitUntilListed();
+                outstanding--;
+            } else {
+                subdirectory->isScheduled = true;
+                subdirectory->list(isFollowingLinks, isFollowingLinks, m_isOneFileSystem, rootDevice);
+            }
+            if (subdirectory->error != 0) {
+                onEntry({subdirectory->path, 0, 0, subdirectory->error});
+                continue;
+            }
+            // Followed links can lead back to a directory that is already being walked.
+            const bool isCycle{
+                std::ranges::any_of(stack, [&subdirectory](const Frame& ancestor) {
+                    return ancestor.directory->device == subdirectory->device &&
+                           ancestor.directory->inode == subdirectory->inode;
+                })
+            };
+            if (subdirectory->isSkipped || isCycle) {
+                subdirectory->release();
+                continue;
+            }
+            enter(std::move(subdirectory));
+        }
+    }
+} // File::Io
@@ -0,0 +1,52 @@
+#ifndef DIRECTORYWALKER_HPP
+#define DIRECTORYWALKER_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <sys/types.h>
+#include "../pool/WorkStealingPool.hpp"
+
+namespace File::Io {
+    // Walks directory trees depth first in name order, which is the order their paths sort in. Directories
+    // are listed ahead of the walk on a pool, so reading them overlaps, while entries are still reported
+    // one at a time on the walking thread.
+    class DirectoryWalker {
+    public:
+        enum class Follow {
+            never,
+            roots,
+            always,
+        };
+
+        struct Entry {
+            std::filesystem::path path;
+            dev_t device;
+            ino_t inode;
+            // Non-zero when the entry is a directory that could not be read.
+            int error;
+        };
+
+        using Callback = std::function<void(Entry&&)>;
+
+        using Filter = std::function<bool(const std::filesystem::path&)>;
+
+    private:
+        struct Directory;
+
+        WorkStealingPool& m_pool;
+        Follow m_follow;
+        bool m_isOneFileSystem;
+        std::size_t m_prefetchLimit;
+
+    public:
+        DirectoryWalker(WorkStealingPool& pool, Follow follow, bool isOneFileSystem) noexcept;
+
+        // Reports every regular file under root and every directory that could not be read. Anything else,
+        // and symbolic links the follow policy leaves alone, is skipped. When given, isWalked picks which
+        // children of root are walked at all, so whole subtrees can be left out unread.
+        void walk(const std::filesystem::path& root, const Callback& onEntry, const Filter& isWalked = {});
+    };
+} // File::Io
+
+#endif //DIRECTORYWALKER_HPP
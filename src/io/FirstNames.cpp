@@ -0,0 +1,74 @@
+#include "FirstNames.hpp"
+#include <utility>
+#include "../Metrics.hpp"
+
+namespace File::Io {
+    FirstNames::FirstNames(ReorderBuffer& results) noexcept : m_results{results} { }
+
+    bool FirstNames::isFirst(const FileIdentity identity) {
+        const Metrics::Timer timer{Metrics::Phase::deduplicate};
+        const std::unique_lock lock{Metrics::lock(m_mutex)};
+        return m_seen.insert(identity).second;
+    }
+
+    void FirstNames::expect(const std::uint64_t sequence) {
+        const std::unique_lock lock{Metrics::lock(m_mutex)};
+        m_expected.emplace(sequence, Expected{false, std::nullopt, std::nullopt});
+    }
+
+    bool FirstNames::identify(const std::uint64_t sequence, const std::optional<FileIdentity> identity) {
+        const Metrics::Timer timer{Metrics::Phase::deduplicate};
+        std::map<std::uint64_t, std::string> released{};
+        bool isLater{false};
+        {
+            const std::unique_lock lock{Metrics::lock(m_mutex)};
+            const auto expected{m_expected.find(sequence)};
+            // Everything in m_seen was settled before this name, so a match there needs no waiting.
+            if (identity.has_value() && m_seen.contains(*identity)) {
+                m_expected.erase(expected);
+                isLater = true;
+            } else {
+                expected->second.isIdentified = true;
+                expected->second.identity = identity;
+                released = settle();
+            }
+        }
+        if (isLater) {
+            m_results.complete(sequence, {});
+        }
+        for (auto& [settled, line]: released) {
+            m_results.complete(settled, std::move(line));
+        }
+        return !isLater;
+    }
+
+    void FirstNames::complete(const std::uint64_t sequence, std::string&& line) {
+        {
+            const std::unique_lock lock{Metrics::lock(m_mutex)};
+            if (const auto expected{m_expected.find(sequence)}; expected != m_expected.end()) {
+                expected->second.line.emplace(std::move(line));
+                return;
+            }
+            if (m_dropped.erase(sequence) != 0) {
+                line.clear();
+            }
+        }
+        m_results.complete(sequence, std::move(line));
+    }
+
+    std::map<std::uint64_t, std::string> FirstNames::settle() {
+        std::map<std::uint64_t, std::string> released{};
+        while (!m_expected.empty() && m_expected.begin()->second.isIdentified) {
+            auto node{m_expected.extract(m_expected.begin())};
+            Expected& expected{node.mapped()};
+            const bool isFirst{!expected.identity.has_value() || m_seen.insert(*expected.identity).second};
+            if (expected.line.has_value()) {
+                released.emplace(node.key(), isFirst ? std::move(*expected.line) : std::string{});
+            } else if (!isFirst) {
+                // Its result is still being worked out; it is blanked when it arrives.
+                m_dropped.insert(node.key());
+            }
+        }
+        return released;
+    }
+} // File::Io
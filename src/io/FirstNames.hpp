@@ -0,0 +1,68 @@
+#ifndef FIRSTNAMES_HPP
+#define FIRSTNAMES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <sys/types.h>
+#include "ReorderBuffer.hpp"
+
+namespace File::Io {
+    struct FileIdentity {
+        dev_t device;
+        ino_t inode;
+
+        bool operator==(const FileIdentity&) const noexcept = default;
+
+        struct Hash {
+            std::size_t operator()(const FileIdentity& identity) const noexcept {
+                return std::hash<ino_t>{}(identity.inode) * 31 + std::hash<dev_t>{}(identity.device);
+            }
+        };
+    };
+
+    // Hard links and different spellings of one path are reported once, under the name submitted first.
+    // Names identified by the producer are settled on the spot. Names whose metadata arrives later, in any
+    // order, are settled in submission order: a result for one waits here until every name expected before
+    // it has been identified, and is dropped if an earlier name turns out to be the same file.
+    class FirstNames {
+        struct Expected {
+            bool isIdentified;
+            std::optional<FileIdentity> identity;
+            std::optional<std::string> line;
+        };
+
+        ReorderBuffer& m_results;
+        std::mutex m_mutex;
+        std::unordered_set<FileIdentity, FileIdentity::Hash> m_seen;
+        std::map<std::uint64_t, Expected> m_expected;
+        std::unordered_set<std::uint64_t> m_dropped;
+
+        // Settles the oldest expected names for as long as they are identified, returning the lines of the
+        // first names among them whose results had already arrived.
+        [[nodiscard]] std::map<std::uint64_t, std::string> settle();
+
+    public:
+        explicit FirstNames(ReorderBuffer& results) noexcept;
+
+        // For a name the producer identified itself: whether it is the first name of the file.
+        [[nodiscard]] bool isFirst(FileIdentity identity);
+
+        // Called by the producer, in submission order, for a name that identify will be called for later.
+        void expect(std::uint64_t sequence);
+
+        // The file behind an expected name, or std::nullopt if it cannot be a duplicate. False if the name is
+        // already known to be a later one; its result is then complete and must not be passed to complete.
+        [[nodiscard]] bool identify(std::uint64_t sequence, std::optional<FileIdentity> identity);
+
+        // Passes a result on to the reorder buffer, holds it until its name is settled, or drops it.
+        void complete(std::uint64_t sequence, std::string&& line);
+    };
+} // File::Io
+
+#endif //FIRSTNAMES_HPP
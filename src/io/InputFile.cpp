@@ -0,0 +1,279 @@
+#include "InputFile.hpp"
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <new>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "RateLimiter.hpp"
+#include "../Metrics.hpp"
+
+namespace File::Io {
+    namespace {
+        constexpr std::size_t spareBufferLimit{4};
+
+        InputFile::ReadPolicy policy{};
+        std::unique_ptr<RateLimiter> limiter{};
+
+        // Freed through the thread-local list's destructor, so the list owns what it holds.
+        struct SpareBuffers {
+            std::vector<std::uint8_t*> buffers{};
+
+            SpareBuffers() = default;
+
+            SpareBuffers(const SpareBuffers&) = delete;
+
+            SpareBuffers& operator=(const SpareBuffers&) = delete;
+
+            ~SpareBuffers() {
+                for (std::uint8_t* buffer: buffers) {
+                    ::operator delete[](buffer, std::align_val_t{InputFile::bufferAlignment});
+                }
+            }
+        };
+
+        thread_local SpareBuffers spares{};
+
+        std::uint8_t* acquireBuffer() {
+            if (!spares.buffers.empty()) {
+                std::uint8_t* buffer{spares.buffers.back()};
+                spares.buffers.pop_back();
+                return buffer;
+            }
+            return static_cast<std::uint8_t*>(
+                ::operator new[](InputFile::chunkSize, std::align_val_t{InputFile::bufferAlignment}));
+        }
+
+        bool isMappable() noexcept {
+            return policy.cacheUse == InputFile::CacheUse::keep && policy.bytesPerSecond == 0;
+        }
+
+        // Every live mapping, so the bus error handler can tell a file that shrank under its mapping from any
+        // other bus error. A slot is claimed by setting begin and freed by clearing end, then begin.
+        struct MappedRange {
+            std::atomic<std::uintptr_t> begin{0};
+            std::atomic<std::uintptr_t> end{0};
+            std::atomic<bool> isFaulted{false};
+        };
+
+        constexpr std::size_t mappedRangeLimit{1024};
+        constexpr std::size_t noSlot{mappedRangeLimit};
+
+        std::array<MappedRange, mappedRangeLimit> mappedRanges{};
+        std::uintptr_t pageSize{0};
+        struct sigaction previousBusAction{};
+
+        // Pages past the end of a truncated file raise SIGBUS when touched. Within a registered mapping the
+        // page is swapped for zeros and the access retried; anything else gets the previous action back and
+        // faults again under it.
+        void onBusError(const int, siginfo_t* info, void*) {
+            const auto address{reinterpret_cast<std::uintptr_t>(info->si_addr)};
+            for (MappedRange& range: mappedRanges) {
+                if (range.begin.load(std::memory_order_acquire) <= address &&
+                    address < range.end.load(std::memory_order_acquire)) {
+                    range.isFaulted.store(true, std::memory_order_relaxed);
+                    void* page{reinterpret_cast<void*>(address & ~(pageSize - 1))};
+                    if (mmap(page, pageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) !=
+                        MAP_FAILED) {
+                        return;
+                    }
+                    break;
+                }
+            }
+            sigaction(SIGBUS, &previousBusAction, nullptr);
+        }
+
+        bool installBusHandler() noexcept {
+            pageSize = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+            struct sigaction action{};
+            action.sa_sigaction = onBusError;
+            action.sa_flags = SA_SIGINFO;
+            sigemptyset(&action.sa_mask);
+            return sigaction(SIGBUS, &action, &previousBusAction) == 0;
+        }
+
+        std::size_t registerMapping(const void* mapping, const std::size_t size) noexcept {
+            static const bool isHandled{installBusHandler()};
+            if (!isHandled) {
+                return noSlot;
+            }
+            const auto begin{reinterpret_cast<std::uintptr_t>(mapping)};
+            for (std::size_t slot = 0; slot < mappedRanges.size(); slot++) {
+                std::uintptr_t free{0};
+                if (mappedRanges[slot].begin.compare_exchange_strong(free, begin, std::memory_order_acq_rel)) {
+                    mappedRanges[slot].isFaulted.store(false, std::memory_order_relaxed);
+                    mappedRanges[slot].end.store(begin + size, std::memory_order_release);
+                    return slot;
+                }
+            }
+            return noSlot;
+        }
+
+        void unregisterMapping(const std::size_t slot) noexcept {
+            mappedRanges[slot].end.store(0, std::memory_order_release);
+            mappedRanges[slot].begin.store(0, std::memory_order_release);
+        }
+    }
+
+    void InputFile::BufferRelease::operator()(std::uint8_t* buffer) const noexcept {
+        if (spares.buffers.size() < spareBufferLimit) {
+            try {
+                spares.buffers.push_back(buffer);
+                return;
+            } catch (const std::bad_alloc&) { }
+        }
+        ::operator delete[](buffer, std::align_val_t{bufferAlignment});
+    }
+
+    InputFile::InputFile(const int descriptor) noexcept : m_descriptor{descriptor},
+                                                          m_mapping{nullptr},
+                                                          m_mappingSize{0},
+                                                          m_mappingSlot{noSlot},
+                                                          m_mappingRead{false},
+                                                          m_buffer{},
+                                                          m_offset{0},
+                                                          m_metadata{} {
+        if (fstat(m_descriptor, &m_metadata) != 0) {
+            m_metadata = {};
+        }
+    }
+
+    InputFile::InputFile(InputFile&& other) noexcept : m_descriptor{other.m_descriptor},
+                                                       m_mapping{other.m_mapping},
+                                                       m_mappingSize{other.m_mappingSize},
+                                                       m_mappingSlot{other.m_mappingSlot},
+                                                       m_mappingRead{other.m_mappingRead},
+                                                       m_buffer{std::move(other.m_buffer)},
+                                                       m_offset{other.m_offset},
+                                                       m_metadata{other.m_metadata} {
+        other.m_descriptor = -1;
+        other.m_mapping = nullptr;
+        other.m_mappingSize = 0;
+        other.m_mappingSlot = noSlot;
+    }
+
+    InputFile::~InputFile() {
+        if (m_mapping != nullptr) {
+            munmap(const_cast<std::uint8_t*>(m_mapping), m_mappingSize);
+            unregisterMapping(m_mappingSlot);
+        }
+        if (m_descriptor >= 0) {
+            // Read-ahead past the last chunk, and pages still being added to the LRU when their chunk was
+            // dropped, would otherwise stay behind.
+            if (policy.cacheUse != CacheUse::keep && m_offset > 0) {
+                posix_fadvise(m_descriptor, 0, 0, POSIX_FADV_DONTNEED);
+            }
+            close(m_descriptor);
+        }
+    }
+
+    void InputFile::setReadPolicy(const ReadPolicy& readPolicy) {
+        policy = readPolicy;
+        limiter = policy.bytesPerSecond == 0 ? nullptr : std::make_unique<RateLimiter>(policy.bytesPerSecond);
+    }
+
+    const InputFile::ReadPolicy& InputFile::readPolicy() noexcept {
+        return policy;
+    }
+
+    std::optional<InputFile> InputFile::open(const std::filesystem::path& path) noexcept {
+        const Metrics::Timer timer{Metrics::Phase::open};
+        int descriptor{-1};
+        if (policy.cacheUse == CacheUse::direct) {
+            descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        }
+        // File systems without O_DIRECT refuse it with EINVAL; those files are dropped behind instead.
+        if (descriptor < 0) {
+            descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        InputFile input{descriptor};
+        input.map();
+        return std::make_optional<InputFile>(std::move(input));
+    }
+
+    std::optional<InputFile> InputFile::standardInput() noexcept {
+        const int descriptor{fcntl(STDIN_FILENO, F_DUPFD_CLOEXEC, 0)};
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        InputFile input{descriptor};
+        if (lseek(descriptor, 0, SEEK_CUR) == 0) {
+            input.map();
+        }
+        return std::make_optional<InputFile>(std::move(input));
+    }
+
+    void InputFile::map() noexcept {
+        if (!isMappable() || !S_ISREG(m_metadata.st_mode) || m_metadata.st_size <= 0) {
+            return;
+        }
+        const auto size{static_cast<std::size_t>(m_metadata.st_size)};
+        void* mapping{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, m_descriptor, 0)};
+        if (mapping == MAP_FAILED) {
+            return;
+        }
+        // Without a slot a truncation would kill the process, so the file is read instead.
+        const std::size_t slot{registerMapping(mapping, size)};
+        if (slot == noSlot) {
+            munmap(mapping, size);
+            return;
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        m_mapping = static_cast<const std::uint8_t*>(mapping);
+        m_mappingSize = size;
+        m_mappingSlot = slot;
+    }
+
+    bool InputFile::isMapped() const noexcept {
+        return m_mapping != nullptr;
+    }
+
+    bool InputFile::isIntact() const noexcept {
+        return m_mapping == nullptr || !mappedRanges[m_mappingSlot].isFaulted.load(std::memory_order_relaxed);
+    }
+
+    const struct stat& InputFile::metadata() const noexcept {
+        return m_metadata;
+    }
+
+    std::span<const std::uint8_t> InputFile::next() {
+        if (m_mapping != nullptr) {
+            if (m_mappingRead) {
+                return {};
+            }
+            m_mappingRead = true;
+            return {m_mapping, m_mappingSize};
+        }
+        if (m_buffer == nullptr) {
+            m_buffer.reset(acquireBuffer());
+        }
+        while (true) {
+            const ssize_t count{read(m_descriptor, m_buffer.get(), chunkSize)};
+            if (count >= 0) {
+                if (policy.cacheUse != CacheUse::keep && count > 0) {
+                    posix_fadvise(m_descriptor, static_cast<off_t>(m_offset), count, POSIX_FADV_DONTNEED);
+                }
+                m_offset += static_cast<std::uint64_t>(count);
+                if (limiter != nullptr) {
+                    limiter->pace(static_cast<std::size_t>(count));
+                }
+                return {m_buffer.get(), static_cast<std::size_t>(count)};
+            }
+            // A short O_DIRECT read leaves the offset unaligned; the rest of the file is read through the cache.
+            if (errno == EINVAL && (fcntl(m_descriptor, F_GETFL) & O_DIRECT) != 0) {
+                fcntl(m_descriptor, F_SETFL, fcntl(m_descriptor, F_GETFL) & ~O_DIRECT);
+                continue;
+            }
+            if (errno != EINTR) {
+                return {};
+            }
+        }
+    }
+} // File::Io
@@ -0,0 +1,90 @@
+#ifndef INPUTFILE_HPP
+#define INPUTFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <sys/stat.h>
+
+namespace File::Io {
+    class InputFile {
+    public:
+        // How reads treat the page cache, for scans sharing a host with workloads whose cache matters.
+        enum class CacheUse {
+            keep,
+            // Each chunk is dropped from the cache with POSIX_FADV_DONTNEED once it has been read.
+            dropBehind,
+            // Reads bypass the cache with O_DIRECT where the file system allows it, dropping behind elsewhere.
+            direct
+        };
+
+        struct ReadPolicy {
+            CacheUse cacheUse{CacheUse::keep};
+            // Shared by every file being read; zero leaves reads unpaced.
+            std::uint64_t bytesPerSecond{0};
+        };
+
+    private:
+        // Returns buffers to a per-thread list for the next file instead of freeing them.
+        struct BufferRelease {
+            void operator()(std::uint8_t* buffer) const noexcept;
+        };
+
+        int m_descriptor;
+        const std::uint8_t* m_mapping;
+        std::size_t m_mappingSize;
+        // Where the mapping is registered with the bus error handler.
+        std::size_t m_mappingSlot;
+        bool m_mappingRead;
+        std::unique_ptr<std::uint8_t[], BufferRelease> m_buffer;
+        std::uint64_t m_offset;
+        struct stat m_metadata;
+
+        explicit InputFile(int descriptor) noexcept;
+
+        void map() noexcept;
+
+    public:
+        // A multiple of every logical block size, as O_DIRECT requires of reads and their buffers.
+        static constexpr std::size_t chunkSize{256 * 1024};
+        static constexpr std::size_t bufferAlignment{4096};
+
+        // Applies to every file opened afterwards. Files are only mapped under the default policy, since
+        // pages faulted in through a mapping can neither be paced nor dropped chunk by chunk.
+        static void setReadPolicy(const ReadPolicy& policy);
+
+        [[nodiscard]] static const ReadPolicy& readPolicy() noexcept;
+
+        [[nodiscard]] static std::optional<InputFile> open(const std::filesystem::path& path) noexcept;
+
+        // Reads standard input from its current position; it is only mapped when that is the start of a file.
+        [[nodiscard]] static std::optional<InputFile> standardInput() noexcept;
+
+        InputFile(const InputFile&) = delete;
+
+        InputFile(InputFile&& other) noexcept;
+
+        InputFile& operator=(const InputFile&) = delete;
+
+        InputFile& operator=(InputFile&&) = delete;
+
+        ~InputFile();
+
+        [[nodiscard]] bool isMapped() const noexcept;
+
+        // False once reading the mapping has run past the end of a file cut short since it was mapped. Those
+        // pages read as zeros instead of raising SIGBUS, so nothing read from the file can be trusted.
+        [[nodiscard]] bool isIntact() const noexcept;
+
+        // What fstat reported when the file was opened.
+        [[nodiscard]] const struct stat& metadata() const noexcept;
+
+        // Returns the next contiguous block of the file; an empty span marks the end of the file.
+        [[nodiscard]] std::span<const std::uint8_t> next();
+    };
+} // File::Io
+
+#endif //INPUTFILE_HPP
@@ -0,0 +1,54 @@
+#include "OutputSink.hpp"
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <unistd.h>
+
+namespace File::Io {
+    OutputSink::OutputSink(const int descriptor, const std::size_t capacity) : m_descriptor{descriptor},
+                                                                               m_buffer(capacity),
+                                                                               m_used{0},
+                                                                               m_lastFlush{
+                                                                                   std::chrono::steady_clock::now()
+                                                                               } { }
+
+    OutputSink::~OutputSink() {
+        try {
+            flush();
+        } catch (const std::system_error&) { }
+    }
+
+    void OutputSink::writeAll(std::string_view bytes) {
+        while (!bytes.empty()) {
+            const ssize_t count{write(m_descriptor, bytes.data(), bytes.size())};
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "Unable to write output. ");
+            }
+            bytes.remove_prefix(static_cast<std::size_t>(count));
+        }
+    }
+
+    void OutputSink::append(const std::string_view bytes) {
+        if (m_used + bytes.size() > m_buffer.size()) {
+            flush();
+        }
+        if (bytes.size() > m_buffer.size()) {
+            writeAll(bytes);
+            return;
+        }
+        std::memcpy(m_buffer.data() + m_used, bytes.data(), bytes.size());
+        m_used += bytes.size();
+        if (std::chrono::steady_clock::now() - m_lastFlush >= flushInterval) {
+            flush();
+        }
+    }
+
+    void OutputSink::flush() {
+        writeAll({m_buffer.data(), m_used});
+        m_used = 0;
+        m_lastFlush = std::chrono::steady_clock::now();
+    }
+} // File::Io
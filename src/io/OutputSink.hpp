@@ -0,0 +1,38 @@
+#ifndef OUTPUTSINK_HPP
+#define OUTPUTSINK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace File::Io {
+    // Accumulates output in one large buffer and hands it to write(2) when it fills up, or when output has
+    // been sitting in it for a while so slow runs still show progress. Not synchronised.
+    class OutputSink {
+        int m_descriptor;
+        std::vector<char> m_buffer;
+        std::size_t m_used;
+        std::chrono::steady_clock::time_point m_lastFlush;
+
+        void writeAll(std::string_view bytes);
+
+    public:
+        static constexpr std::size_t defaultCapacity{1024 * 1024};
+        static constexpr std::chrono::milliseconds flushInterval{50};
+
+        explicit OutputSink(int descriptor, std::size_t capacity = defaultCapacity);
+
+        OutputSink(const OutputSink&) = delete;
+
+        OutputSink& operator=(const OutputSink&) = delete;
+
+        ~OutputSink();
+
+        void append(std::string_view bytes);
+
+        void flush();
+    };
+} // File::Io
+
+#endif //OUTPUTSINK_HPP
@@ -0,0 +1,20 @@
+#include "RateLimiter.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace File::Io {
+    RateLimiter::RateLimiter(const std::uint64_t bytesPerSecond) noexcept : m_bytesPerSecond{bytesPerSecond},
+                                                                            m_next{} { }
+
+    void RateLimiter::pace(const std::size_t bytes) {
+        std::chrono::steady_clock::time_point start{};
+        {
+            const std::lock_guard guard{m_mutex};
+            start = std::max(m_next, std::chrono::steady_clock::now());
+            m_next = start + std::chrono::nanoseconds{
+                         static_cast<std::chrono::nanoseconds::rep>(bytes * 1'000'000'000.0 / m_bytesPerSecond)
+                     };
+        }
+        std::this_thread::sleep_until(start);
+    }
+} // File::Io
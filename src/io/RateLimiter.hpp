@@ -0,0 +1,28 @@
+#ifndef RATELIMITER_HPP
+#define RATELIMITER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace File::Io {
+    // Paces reads from every thread to one shared byte rate. Each read books the next slice of a virtual
+    // clock after it completes and sleeps until that slice starts, so a burst is at most one read long.
+    class RateLimiter {
+        std::uint64_t m_bytesPerSecond;
+        std::mutex m_mutex;
+        std::chrono::steady_clock::time_point m_next;
+
+    public:
+        explicit RateLimiter(std::uint64_t bytesPerSecond) noexcept;
+
+        RateLimiter(const RateLimiter&) = delete;
+
+        RateLimiter& operator=(const RateLimiter&) = delete;
+
+        void pace(std::size_t bytes);
+    };
+} // File::Io
+
+#endif //RATELIMITER_HPP
@@ -0,0 +1,38 @@
+#include "ReorderBuffer.hpp"
+#include <algorithm>
+#include "../Metrics.hpp"
+
+namespace File::Io {
+    ReorderBuffer::ReorderBuffer(OutputSink& sink, const std::size_t window, const bool isOrdered) : m_sink{sink},
+        m_isOrdered{isOrdered},
+        m_slots(std::max<std::size_t>(window, 1)),
+        m_next{0} { }
+
+    void ReorderBuffer::waitForSlot(const std::uint64_t sequence) {
+        if (!m_isOrdered) {
+            return;
+        }
+        std::unique_lock lock{m_mutex};
+        m_released.wait(lock, [this, sequence] { return sequence < m_next + m_slots.size(); });
+    }
+
+    void ReorderBuffer::complete(const std::uint64_t sequence, std::string&& line) {
+        const std::unique_lock lock{Metrics::lock(m_mutex)};
+        if (!m_isOrdered) {
+            m_sink.append(line);
+            return;
+        }
+        m_slots[sequence % m_slots.size()].emplace(std::move(line));
+        bool released{false};
+        for (std::optional<std::string>* slot{&m_slots[m_next % m_slots.size()]}; slot->has_value();
+             slot = &m_slots[m_next % m_slots.size()]) {
+            m_sink.append(**slot);
+            slot->reset();
+            m_next++;
+            released = true;
+        }
+        if (released) {
+            m_released.notify_all();
+        }
+    }
+} // File::Io
@@ -0,0 +1,35 @@
+#ifndef REORDERBUFFER_HPP
+#define REORDERBUFFER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "OutputSink.hpp"
+
+namespace File::Io {
+    // Releases results numbered 0, 1, 2, ... to a sink as soon as they can be printed. In ordered mode a
+    // result waits in a ring of window slots until everything before it has been printed; producers must
+    // not run further ahead than the window. In unordered mode results are printed as they complete.
+    class ReorderBuffer {
+        OutputSink& m_sink;
+        bool m_isOrdered;
+        std::mutex m_mutex;
+        std::condition_variable m_released;
+        std::vector<std::optional<std::string>> m_slots;
+        std::uint64_t m_next;
+
+    public:
+        ReorderBuffer(OutputSink& sink, std::size_t window, bool isOrdered);
+
+        // Blocks until the result with this sequence number fits into the window.
+        void waitForSlot(std::uint64_t sequence);
+
+        void complete(std::uint64_t sequence, std::string&& line);
+    };
+} // File::Io
+
+#endif //REORDERBUFFER_HPP
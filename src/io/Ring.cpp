@@ -0,0 +1,175 @@
+#include "Ring.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace File::Io {
+    namespace {
+        int setup(const unsigned entries, io_uring_params& parameters) noexcept {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, &parameters));
+        }
+
+        int enter(const int descriptor, const unsigned submitted, const unsigned waitFor,
+                  const unsigned flags) noexcept {
+            return static_cast<int>(syscall(__NR_io_uring_enter, descriptor, submitted, waitFor, flags, nullptr, 0));
+        }
+    }
+
+    Ring::Ring(const int descriptor) noexcept : m_descriptor{descriptor},
+                                                m_submissionMapping{nullptr},
+                                                m_submissionMappingSize{0},
+                                                m_completionMapping{nullptr},
+                                                m_completionMappingSize{0},
+                                                m_entries{nullptr},
+                                                m_entriesSize{0},
+                                                m_submissionHead{nullptr},
+                                                m_submissionTail{nullptr},
+                                                m_submissionMask{0},
+                                                m_submissionArray{nullptr},
+                                                m_submissionCapacity{0},
+                                                m_completionHead{nullptr},
+                                                m_completionTail{nullptr},
+                                                m_completionMask{0},
+                                                m_completions{nullptr},
+                                                m_unsubmitted{0} { }
+
+    Ring::Ring(Ring&& other) noexcept : Ring{other.m_descriptor} {
+        m_submissionMapping = other.m_submissionMapping;
+        m_submissionMappingSize = other.m_submissionMappingSize;
+        m_completionMapping = other.m_completionMapping;
+        m_completionMappingSize = other.m_completionMappingSize;
+        m_entries = other.m_entries;
+        m_entriesSize = other.m_entriesSize;
+        m_submissionHead = other.m_submissionHead;
+        m_submissionTail = other.m_submissionTail;
+        m_submissionMask = other.m_submissionMask;
+        m_submissionArray = other.m_submissionArray;
+        m_submissionCapacity = other.m_submissionCapacity;
+        m_completionHead = other.m_completionHead;
+        m_completionTail = other.m_completionTail;
+        m_completionMask = other.m_completionMask;
+        m_completions = other.m_completions;
+        m_unsubmitted = other.m_unsubmitted;
+        other.m_descriptor = -1;
+        other.m_submissionMapping = nullptr;
+        other.m_completionMapping = nullptr;
+        other.m_entries = nullptr;
+    }
+
+    Ring::~Ring() {
+        if (m_entries != nullptr) {
+            munmap(m_entries, m_entriesSize);
+        }
+        if (m_completionMapping != nullptr && m_completionMapping != m_submissionMapping) {
+            munmap(m_completionMapping, m_completionMappingSize);
+        }
+        if (m_submissionMapping != nullptr) {
+            munmap(m_submissionMapping, m_submissionMappingSize);
+        }
+        if (m_descriptor >= 0) {
+            close(m_descriptor);
+        }
+    }
+
+    std::optional<Ring> Ring::create(const unsigned entries) noexcept {
+        io_uring_params parameters{};
+        const int descriptor{setup(entries, parameters)};
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        Ring ring{descriptor};
+        ring.m_submissionMappingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+        ring.m_completionMappingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+        const bool isSingleMapping{(parameters.features & IORING_FEAT_SINGLE_MMAP) != 0};
+        if (isSingleMapping) {
+            ring.m_submissionMappingSize = std::max(ring.m_submissionMappingSize, ring.m_completionMappingSize);
+        }
+        void* submission{
+            mmap(nullptr, ring.m_submissionMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor,
+                 IORING_OFF_SQ_RING)
+        };
+        if (submission == MAP_FAILED) {
+            return std::nullopt;
+        }
+        ring.m_submissionMapping = submission;
+        void* completion{submission};
+        if (!isSingleMapping) {
+            completion = mmap(nullptr, ring.m_completionMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              descriptor, IORING_OFF_CQ_RING);
+            if (completion == MAP_FAILED) {
+                return std::nullopt;
+            }
+        }
+        ring.m_completionMapping = completion;
+        ring.m_entriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+        void* submissionEntries{
+            mmap(nullptr, ring.m_entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor,
+                 IORING_OFF_SQES)
+        };
+        if (submissionEntries == MAP_FAILED) {
+            return std::nullopt;
+        }
+        ring.m_entries = static_cast<io_uring_sqe*>(submissionEntries);
+        auto* submissionBytes{static_cast<char*>(submission)};
+        ring.m_submissionHead = reinterpret_cast<unsigned*>(submissionBytes + parameters.sq_off.head);
+        ring.m_submissionTail = reinterpret_cast<unsigned*>(submissionBytes + parameters.sq_off.tail);
+        ring.m_submissionMask = *reinterpret_cast<unsigned*>(submissionBytes + parameters.sq_off.ring_mask);
+        ring.m_submissionArray = reinterpret_cast<unsigned*>(submissionBytes + parameters.sq_off.array);
+        ring.m_submissionCapacity = parameters.sq_entries;
+        auto* completionBytes{static_cast<char*>(completion)};
+        ring.m_completionHead = reinterpret_cast<unsigned*>(completionBytes + parameters.cq_off.head);
+        ring.m_completionTail = reinterpret_cast<unsigned*>(completionBytes + parameters.cq_off.tail);
+        ring.m_completionMask = *reinterpret_cast<unsigned*>(completionBytes + parameters.cq_off.ring_mask);
+        ring.m_completions = reinterpret_cast<io_uring_cqe*>(completionBytes + parameters.cq_off.cqes);
+        return std::make_optional<Ring>(std::move(ring));
+    }
+
+    bool Ring::supports(const std::initializer_list<std::uint8_t> operations) noexcept {
+        const std::optional ring{create(1)};
+        if (!ring.has_value()) {
+            return false;
+        }
+        constexpr unsigned probed{256};
+        std::vector<std::uint8_t> storage(sizeof(io_uring_probe) + probed * sizeof(io_uring_probe_op));
+        auto* probe{reinterpret_cast<io_uring_probe*>(storage.data())};
+        if (syscall(__NR_io_uring_register, ring->m_descriptor, IORING_REGISTER_PROBE, probe, probed) < 0) {
+            return false;
+        }
+        for (const std::uint8_t operation: operations) {
+            if (operation > probe->last_op || (probe->ops[operation].flags & IO_URING_OP_SUPPORTED) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    io_uring_sqe* Ring::prepare() noexcept {
+        const unsigned head{__atomic_load_n(m_submissionHead, __ATOMIC_ACQUIRE)};
+        const unsigned tail{*m_submissionTail};
+        if (tail - head >= m_submissionCapacity) {
+            return nullptr;
+        }
+        const unsigned index{tail & m_submissionMask};
+        io_uring_sqe* entry{&m_entries[index]};
+        std::memset(entry, 0, sizeof(io_uring_sqe));
+        m_submissionArray[index] = index;
+        __atomic_store_n(m_submissionTail, tail + 1, __ATOMIC_RELEASE);
+        m_unsubmitted++;
+        return entry;
+    }
+
+    int Ring::submit(const unsigned waitFor) noexcept {
+        int result;
+        do {
+            result = enter(m_descriptor, m_unsubmitted, waitFor, waitFor > 0 ? IORING_ENTER_GETEVENTS : 0);
+        } while (result < 0 && errno == EINTR);
+        if (result >= 0) {
+            m_unsubmitted -= std::min(m_unsubmitted, static_cast<unsigned>(result));
+        }
+        return result;
+    }
+} // File::Io
@@ -0,0 +1,72 @@
+#ifndef RING_HPP
+#define RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <linux/io_uring.h>
+
+namespace File::Io {
+    // A minimal io_uring instance driven through the raw system calls, so no liburing is needed.
+    // Not synchronised; each thread that submits I/O owns its own ring.
+    class Ring {
+        int m_descriptor;
+        void* m_submissionMapping;
+        std::size_t m_submissionMappingSize;
+        void* m_completionMapping;
+        std::size_t m_completionMappingSize;
+        io_uring_sqe* m_entries;
+        std::size_t m_entriesSize;
+        unsigned* m_submissionHead;
+        unsigned* m_submissionTail;
+        unsigned m_submissionMask;
+        unsigned* m_submissionArray;
+        unsigned m_submissionCapacity;
+        unsigned* m_completionHead;
+        unsigned* m_completionTail;
+        unsigned m_completionMask;
+        io_uring_cqe* m_completions;
+        unsigned m_unsubmitted;
+
+        explicit Ring(int descriptor) noexcept;
+
+    public:
+        [[nodiscard]] static std::optional<Ring> create(unsigned entries) noexcept;
+
+        // Whether the kernel lets this process use io_uring with every given operation.
+        [[nodiscard]] static bool supports(std::initializer_list<std::uint8_t> operations) noexcept;
+
+        Ring(const Ring&) = delete;
+
+        Ring(Ring&& other) noexcept;
+
+        Ring& operator=(const Ring&) = delete;
+
+        Ring& operator=(Ring&&) = delete;
+
+        ~Ring();
+
+        // A cleared submission entry to fill in, or nullptr while the submission queue is full.
+        [[nodiscard]] io_uring_sqe* prepare() noexcept;
+
+        // Submits every prepared entry and blocks until at least waitFor completions are available.
+        int submit(unsigned waitFor) noexcept;
+
+        // Hands every available completion to onCompletion and returns how many there were.
+        template<class Callback>
+        unsigned drain(Callback&& onCompletion) {
+            unsigned head{__atomic_load_n(m_completionHead, __ATOMIC_RELAXED)};
+            const unsigned tail{__atomic_load_n(m_completionTail, __ATOMIC_ACQUIRE)};
+            unsigned count{0};
+            for (; head != tail; head++, count++) {
+                const io_uring_cqe completion{m_completions[head & m_completionMask]};
+                __atomic_store_n(m_completionHead, head + 1, __ATOMIC_RELEASE);
+                onCompletion(completion);
+            }
+            return count;
+        }
+    };
+} // File::Io
+
+#endif //RING_HPP
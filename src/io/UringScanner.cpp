@@ -0,0 +1,243 @@
+#include "UringScanner.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../Classifier.hpp"
+#include "../Metrics.hpp"
+
+namespace File::Io {
+    struct UringScanner::Flight {
+        enum class Stage {
+            metadata,
+            open,
+            read,
+        };
+
+        Job job{};
+        Stage stage{Stage::metadata};
+        int descriptor{-1};
+        struct statx metadata{};
+        std::vector<std::uint8_t> buffer{};
+        std::uint64_t offset{0};
+        Classifier classifier{};
+        // When the statx or openat in flight was submitted, for --stats.
+        std::chrono::steady_clock::time_point submitted{};
+    };
+
+    UringScanner::Worker::Worker(Ring&& ring) noexcept : ring{std::move(ring)} { }
+
+    UringScanner::UringScanner() noexcept : m_nextWorker{0}, m_unfinished{0}, m_stopping{false} { }
+
+    std::unique_ptr<UringScanner> UringScanner::create(const std::size_t threadCount) {
+        if (!Ring::supports({IORING_OP_STATX, IORING_OP_OPENAT, IORING_OP_READ})) {
+            return nullptr;
+        }
+        std::unique_ptr<UringScanner> scanner{new UringScanner{}};
+        for (std::size_t i = 0; i < std::max<std::size_t>(threadCount, 1); i++) {
+            std::optional ring{Ring::create(filesInFlight)};
+            if (!ring.has_value()) {
+                return nullptr;
+            }
+            scanner->m_workers.emplace_back(std::make_unique<Worker>(std::move(*ring)));
+        }
+        for (const std::unique_ptr<Worker>& worker: scanner->m_workers) {
+            scanner->m_threads.emplace_back([scanner = scanner.get(), worker = worker.get()] {
+                scanner->run(*worker);
+            });
+        }
+        return scanner;
+    }
+
+    UringScanner::~UringScanner() {
+        wait();
+        m_stopping = true;
+        for (const std::unique_ptr<Worker>& worker: m_workers) {
+            std::lock_guard guard{worker->mutex};
+            worker->jobAvailable.notify_all();
+        }
+        for (std::thread& thread: m_threads) {
+            thread.join();
+        }
+    }
+
+    void UringScanner::submit(Job&& job) {
+        {
+            std::lock_guard guard{m_stateMutex};
+            m_unfinished++;
+        }
+        Worker& worker{*m_workers[m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size()]};
+        std::lock_guard guard{worker.mutex};
+        worker.jobs.emplace_back(std::move(job));
+        worker.jobAvailable.notify_one();
+    }
+
+    void UringScanner::waitForCapacity(const std::size_t limit) {
+        std::unique_lock lock{m_stateMutex};
+        m_jobFinished.wait(lock, [this, limit] { return m_unfinished < limit; });
+    }
+
+    void UringScanner::wait() {
+        waitForCapacity(1);
+    }
+
+    void UringScanner::finishJob() {
+        std::lock_guard guard{m_stateMutex};
+        m_unfinished--;
+        m_jobFinished.notify_all();
+    }
+
+    void UringScanner::run(Worker& worker) {
+        std::vector<Flight> flights(filesInFlight);
+        std::vector<std::size_t> idle{};
+        for (std::size_t i = filesInFlight; i > 0; i--) {
+            idle.push_back(i - 1);
+        }
+        // Every flight has at most one operation outstanding, so the submission queue never overflows.
+        auto prepare{
+            [&worker, &flights](const std::size_t index) {
+                Flight& flight{flights[index]};
+                io_uring_sqe* entry{worker.ring.prepare()};
+                entry->user_data = index;
+                if (flight.stage != Flight::Stage::read && Metrics::isEnabled()) {
+                    flight.submitted = std::chrono::steady_clock::now();
+                }
+                switch (flight.stage) {
+                    case Flight::Stage::metadata:
+                        entry->opcode = IORING_OP_STATX;
+                        entry->fd = AT_FDCWD;
+                        entry->addr = reinterpret_cast<std::uint64_t>(flight.job.path.c_str());
+                        entry->len = STATX_BASIC_STATS;
+                        entry->off = reinterpret_cast<std::uint64_t>(&flight.metadata);
+                        break;
+                    case Flight::Stage::open:
+                        entry->opcode = IORING_OP_OPENAT;
+                        entry->fd = AT_FDCWD;
+                        entry->addr = reinterpret_cast<std::uint64_t>(flight.job.path.c_str());
+                        entry->open_flags = O_RDONLY | O_CLOEXEC | O_NOCTTY;
+                        break;
+                    case Flight::Stage::read:
+                        entry->opcode = IORING_OP_READ;
+                        entry->fd = flight.descriptor;
+                        entry->addr = reinterpret_cast<std::uint64_t>(flight.buffer.data());
+                        entry->len = static_cast<unsigned>(
+                            std::min<std::uint64_t>(flight.buffer.size(), flight.job.byteLimit - flight.offset));
+                        entry->off = flight.offset;
+                        break;
+                }
+            }
+        };
+        auto retire{
+            [this, &flights, &idle](const std::size_t index) {
+                Flight& flight{flights[index]};
+                if (flight.descriptor >= 0) {
+                    close(flight.descriptor);
+                    flight.descriptor = -1;
+                }
+                flight.job = {};
+                idle.push_back(index);
+                finishJob();
+            }
+        };
+        auto complete{
+            [&flights, &retire](const std::size_t index, const int error, const bool isTruncated) {
+                Flight& flight{flights[index]};
+                const FileType type{isTruncated ? flight.classifier.provisional() : flight.classifier.finish()};
+                if (error == 0) {
+                    Metrics::addClassified(flight.classifier.isDecided() &&
+                                           flight.classifier.bytesScanned() < flight.metadata.stx_size);
+                }
+                flight.job.onFinished({error, type, isTruncated, flight.metadata});
+                retire(index);
+            }
+        };
+        std::vector<Job> arrived{};
+        while (true) {
+            {
+                std::unique_lock lock{worker.mutex};
+                if (idle.size() == filesInFlight) {
+                    worker.jobAvailable.wait(lock, [this, &worker] { return !worker.jobs.empty() || m_stopping; });
+                    if (worker.jobs.empty()) {
+                        return;
+                    }
+                }
+                while (arrived.size() < idle.size() && !worker.jobs.empty()) {
+                    arrived.emplace_back(std::move(worker.jobs.front()));
+                    worker.jobs.pop_front();
+                }
+            }
+            for (Job& job: arrived) {
+                const std::size_t index{idle.back()};
+                idle.pop_back();
+                Flight& flight{flights[index]};
+                flight.job = std::move(job);
+                flight.stage = Flight::Stage::metadata;
+                flight.offset = 0;
+                flight.classifier.reset();
+                prepare(index);
+            }
+            arrived.clear();
+            if (worker.ring.submit(1) < 0) {
+                continue;
+            }
+            worker.ring.drain([&](const io_uring_cqe& completion) {
+                const auto index{static_cast<std::size_t>(completion.user_data)};
+                Flight& flight{flights[index]};
+                const int result{completion.res};
+                switch (flight.stage) {
+                    case Flight::Stage::metadata:
+                        Metrics::addElapsed(Metrics::Phase::metadata, flight.submitted);
+                        if (!flight.job.onMetadata(result < 0 ? -result : 0, flight.metadata) || result < 0) {
+                            retire(index);
+                            return;
+                        }
+                        flight.stage = Flight::Stage::open;
+                        prepare(index);
+                        return;
+                    case Flight::Stage::open:
+                        Metrics::addElapsed(Metrics::Phase::open, flight.submitted);
+                        if (result < 0) {
+                            complete(index, -result, false);
+                            return;
+                        }
+                        flight.descriptor = result;
+                        flight.buffer.resize(readSize);
+                        flight.stage = Flight::Stage::read;
+                        prepare(index);
+                        return;
+                    case Flight::Stage::read:
+                        if (result == -EINTR || result == -EAGAIN) {
+                            prepare(index);
+                            return;
+                        }
+                        if (result < 0) {
+                            complete(index, -result, false);
+                            return;
+                        }
+                        if (result == 0) {
+                            complete(index, 0, false);
+                            return;
+                        }
+                        {
+                            const Metrics::Timer timer{Metrics::Phase::scan};
+                            flight.classifier.feed(std::span{flight.buffer.data(), static_cast<std::size_t>(result)});
+                        }
+                        flight.offset += static_cast<std::uint64_t>(result);
+                        if (flight.classifier.isDecided()) {
+                            complete(index, 0, false);
+                            return;
+                        }
+                        if (flight.offset >= flight.job.byteLimit) {
+                            complete(index, 0, flight.offset < flight.metadata.stx_size);
+                            return;
+                        }
+                        prepare(index);
+                        return;
+                }
+            });
+        }
+    }
+} // File::Io
@@ -0,0 +1,94 @@
+#ifndef URINGSCANNER_HPP
+#define URINGSCANNER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include "../FileType.hpp"
+#include "Ring.hpp"
+
+namespace File::Io {
+    // Classifies many files at once from a few threads, each keeping up to filesInFlight files moving
+    // through statx, openat and read on its own io_uring, and feeding every completed read to a Classifier.
+    class UringScanner {
+    public:
+        struct Outcome {
+            // The errno of a failed openat or read, or 0.
+            int error;
+            FileType type;
+            // Whether the byte limit stopped reading before the end of the file.
+            bool isTruncated;
+            struct statx metadata;
+        };
+
+        // Runs on a scanner thread once statx has finished, with its errno or 0. Returning false ends the job
+        // without reading the file, and without calling the completion.
+        using MetadataCheck = std::function<bool(int error, const struct statx& metadata)>;
+
+        using Completion = std::function<void(Outcome&& outcome)>;
+
+        struct Job {
+            std::filesystem::path path;
+            std::uint64_t byteLimit;
+            MetadataCheck onMetadata;
+            Completion onFinished;
+        };
+
+    private:
+        struct Flight;
+
+        struct Worker {
+            Ring ring;
+            std::mutex mutex{};
+            std::condition_variable jobAvailable{};
+            std::deque<Job> jobs{};
+
+            explicit Worker(Ring&& ring) noexcept;
+        };
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
+        std::atomic<std::size_t> m_nextWorker;
+        std::mutex m_stateMutex;
+        std::condition_variable m_jobFinished;
+        std::size_t m_unfinished;
+        std::atomic<bool> m_stopping;
+
+        UringScanner() noexcept;
+
+        void run(Worker& worker);
+
+        void finishJob();
+
+    public:
+        static constexpr unsigned filesInFlight{64};
+        static constexpr std::size_t readSize{128 * 1024};
+
+        // Nullptr when io_uring or one of the operations it needs is unavailable to this process.
+        [[nodiscard]] static std::unique_ptr<UringScanner> create(std::size_t threadCount);
+
+        UringScanner(const UringScanner&) = delete;
+
+        UringScanner& operator=(const UringScanner&) = delete;
+
+        ~UringScanner();
+
+        void submit(Job&& job);
+
+        // Blocks until fewer than limit submitted jobs are unfinished, bounding what a producer queues.
+        void waitForCapacity(std::size_t limit);
+
+        void wait();
+    };
+} // File::Io
+
+#endif //URINGSCANNER_HPP
@@ -1,310 +1,1237 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
 #include <cstdint>
 #include <cstdlib>
+#include <ctime>
 #include <exception>
+#include <functional>
+#include <limits>
 #include <filesystem>
-#include <fstream>
+#include <iomanip>
 #include <iostream>
-#include <map>
-#include <mutex>
+#include <memory>
 #include <optional>
+#include <queue>
+#include <ranges>
+#include <span>
+#include <stdexcept>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <variant>
 #include <vector>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+#include "ChunkSummary.hpp"
+#include "Classifier.hpp"
+#include "FileState.hpp"
+#include "FileType.hpp"
+#include "Metrics.hpp"
+#include "cache/ResultCache.hpp"
+#include "daemon/Protocol.hpp"
+#include "daemon/Server.hpp"
 #include "vle.hpp"
+#include "io/DelimitedReader.hpp"
+#include "io/DirectoryWalker.hpp"
+#include "io/FirstNames.hpp"
+#include "io/InputFile.hpp"
+#include "io/OutputSink.hpp"
+#include "io/ReorderBuffer.hpp"
+#include "io/UringScanner.hpp"
+#include "pool/WorkStealingPool.hpp"
 #include "vle/GbSequence.hpp"
-#include "vle/Unicode.hpp"
+#include "vle/GbValidator.hpp"
 #include "vle/unicode/Utf16Sequence.hpp"
+#include "vle/unicode/Utf16Validator.hpp"
 #include "vle/unicode/Utf8Sequence.hpp"
+#include "vle/unicode/Utf8Validator.hpp"
 
 static_assert(File::Vle<File::GbSequence, std::uint8_t>);
 static_assert(File::Vle<File::Unicode::Utf8Sequence, std::uint8_t>);
 static_assert(File::Vle<File::Unicode::Utf16Sequence, std::uint16_t>);
+static_assert(File::BlockVle<File::Unicode::Utf8Validator, std::uint8_t>);
+static_assert(File::BlockVle<File::Unicode::Utf16Validator, std::uint8_t>);
+static_assert(File::BlockVle<File::GbValidator, std::uint8_t>);
 
-template<typename Point, File::Vle<Point> T>
-void validateVle(bool& isValid, std::optional<T>& vleSequence, typename T::Point point) {
-    if (vleSequence.has_value()) {
-        T& sequence{vleSequence.value()};
-        if (!sequence.isComplete() && !sequence.addPoint(point)) {
-            isValid = false;
-            return;
-        }
-        if (sequence.isComplete()) {
-            if (!sequence.isValid()) {
-                isValid = false;
-            }
-            vleSequence.reset();
-            return;
-        }
-        return;
-    }
-    std::optional<T> possibleSequence{T::build(point)};
-    if (possibleSequence.has_value()) {
-        T sequence{possibleSequence.value()};
-        if (!sequence.isComplete()) {
-            vleSequence.emplace(sequence);
-            return;
-        }
-        if (!sequence.isValid()) {
-            isValid = false;
-            return;
-        }
-        return;
-    }
-    isValid = false;
-}
+using File::FileType;
+
+using File::FileError;
+using File::FileState;
+
+// A verdict reached without reading the whole file is tentative, unless nothing read could be text.
+struct Verdict {
+    FileState state;
+    bool isTentative;
+};
+
+constexpr std::uintmax_t parallelThreshold{32 * 1024 * 1024};
+constexpr std::size_t minimumChunkSize{8 * 1024 * 1024};
 
-enum class FileType {
-    empty,
+constexpr std::size_t queuedTasksPerThread{64};
+constexpr std::uint64_t defaultSampleBytes{1024 * 1024};
+constexpr std::size_t sampleWindows{16};
+constexpr std::string_view standardInputName{"/dev/stdin"};
+
+// The encoding sets with a prebuilt classifier, selected with --encodings.
+enum class EncodingSet {
+    all,
     ascii,
-    latin1,
     utf8,
-    utf16,
-    gb,
-    data
+    unicode,
+    western,
+    chinese
+};
+
+// Shard index of count, both from one: paths whose hash falls elsewhere belong to another node.
+struct Shard {
+    std::uint64_t index;
+    std::uint64_t count;
+};
+
+enum class StatsFormat {
+    none,
+    table,
+    json
 };
 
-enum class FileError {
-    metadataError,
-    doesNotExist,
-    invalidPerms,
-    notRegularFile,
-    unreadable,
+struct Options {
+    std::size_t threadCount{File::WorkStealingPool::defaultThreadCount()};
+    std::optional<std::string> filesFrom{};
+    char listDelimiter{'\n'};
+    bool unordered{false};
+    std::uint64_t byteLimit{std::numeric_limits<std::uint64_t>::max()};
+    bool sample{false};
+    std::optional<std::string> cachePath{};
+    bool isRecursive{false};
+    bool isOneFileSystem{false};
+    File::Io::DirectoryWalker::Follow follow{File::Io::DirectoryWalker::Follow::roots};
+    std::optional<std::string> daemonSocket{};
+    bool useIoUring{false};
+    StatsFormat stats{StatsFormat::none};
+    EncodingSet encodings{EncodingSet::all};
+    std::optional<Shard> shard{};
+    bool isMerging{false};
+    File::Io::InputFile::ReadPolicy readPolicy{};
+    std::vector<char*> paths{};
 };
 
-using FileState = std::variant<FileType, FileError>;
+const File::Daemon::Server* runningServer{nullptr};
+
+Options parseArguments(int argc, char* argv[]);
+
+void file(Options&& options);
+
+void serve(Options&& options);
+
+void merge(Options&& options);
+
+void stopServer(int signal);
+
+std::optional<File::ResultCache> openCache(const Options& options);
+
+void printStats(StatsFormat format, const File::Metrics::Snapshot& snapshot, std::uint64_t wallNanos);
+
+FileState classifyRequest(File::Daemon::RequestKind kind, std::span<const std::uint8_t> payload,
+                          File::ResultCache* cache);
+
+bool isInShard(const std::optional<Shard>& shard, const std::filesystem::path& path) noexcept;
+
+std::filesystem::path displayPath(const char* arg);
+
+std::string_view describe(FileState state);
+
+std::optional<FileError> findMetadata(const std::filesystem::path& path, struct stat& metadata) noexcept;
 
-void file(std::vector<char*>&& args);
+FileError metadataErrorOf(int error) noexcept;
 
-std::optional<FileError> findMetadata(const std::filesystem::path& path) noexcept;
+struct stat statusOf(const struct statx& metadata) noexcept;
 
+std::optional<FileError> checkMetadata(const struct stat& metadata) noexcept;
 
-FileState classifyFile(std::ifstream&& fileReader);
+File::ResultCache::Key cacheKey(const struct stat& metadata) noexcept;
+
+Verdict classifyFile(File::Io::InputFile&& input, std::uint64_t byteLimit,
+                     EncodingSet encodings = EncodingSet::all);
+
+template<class Classifier>
+Verdict classifyWith(File::Io::InputFile&& input, std::uint64_t byteLimit);
+
+Verdict classifySample(File::Io::InputFile&& input, std::uint64_t byteBudget);
+
+void classifyInParallel(File::WorkStealingPool& pool, File::Io::InputFile&& input,
+                        std::function<void(FileState)> onVerdict);
+
+void recordEliminations(const std::array<bool, 5>& wasCandidate, const File::ChunkSummary& summary,
+                        std::uint64_t end) noexcept;
+
+// Classifies the paths of one run and prints their verdicts. The producer hands every path to submit, which
+// settles it on the spot, walks it, or passes it to one of two backends: the pool, which opens and reads
+// each file on a worker thread, or the io_uring scanner, which also takes over the stat. Every path gets a
+// sequence number in submission order, and results are printed in that order unless --unordered.
+class Pipeline {
+    const Options& m_options;
+    std::optional<File::ResultCache> m_cache;
+    File::WorkStealingPool m_pool;
+    std::size_t m_queueLimit;
+    File::Io::OutputSink m_sink;
+    File::Io::ReorderBuffer m_results;
+    // Hard links and different spellings of one path are classified once, under the first name submitted.
+    File::Io::FirstNames m_firstNames;
+    std::unique_ptr<File::Io::UringScanner> m_scanner;
+    File::Io::DirectoryWalker m_walker;
+    File::Io::DirectoryWalker::Filter m_isWalked;
+    std::uint64_t m_sequence;
+
+    void record(std::uint64_t sequence, const std::filesystem::path& path, FileState state,
+                bool isTentative = false);
+
+    void remember(const File::ResultCache::Key& key, FileState state);
+
+    // Reports a verdict the producer already knows under the next sequence number.
+    void report(const std::filesystem::path& path, FileState state);
+
+    void onEntry(File::Io::DirectoryWalker::Entry&& entry);
+
+    // The pool backend. A known key means the producer has already stat'ed the path.
+    void enqueue(std::filesystem::path&& path, std::optional<File::ResultCache::Key> knownKey);
+
+    void classifyQueued(const std::filesystem::path& path, std::optional<File::ResultCache::Key> knownKey,
+                        std::uint64_t sequence);
+
+    // The io_uring backend. Paths not yet deduplicated are identified to m_firstNames once their statx is in.
+    void scan(std::filesystem::path&& path, bool isDeduplicated);
+
+    [[nodiscard]] bool checkScanned(const std::filesystem::path& path, std::uint64_t sequence, bool isDeduplicated,
+                                    int error, const struct statx& metadata);
+
+    void finishScanned(const std::filesystem::path& path, std::uint64_t sequence,
+                       File::Io::UringScanner::Outcome&& outcome);
+
+public:
+    explicit Pipeline(const Options& options);
+
+    Pipeline(const Pipeline&) = delete;
+
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    void submit(std::filesystem::path&& path);
+
+    // Waits for every submitted path to be reported.
+    void finish();
+};
 
 int main(const int argc, char* argv[]) {
     try {
-        if (argc <= 1) {
-            throw std::invalid_argument("Invalid number of arguments.");
+        Options options{parseArguments(argc, argv)};
+        File::Io::InputFile::setReadPolicy(options.readPolicy);
+        const StatsFormat stats{options.stats};
+        if (stats != StatsFormat::none) {
+            File::Metrics::enable();
+        }
+        const std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+        if (options.daemonSocket.has_value()) {
+            serve(std::move(options));
+        } else if (options.isMerging) {
+            merge(std::move(options));
+        } else {
+            file(std::move(options));
+        }
+        if (stats != StatsFormat::none) {
+            printStats(stats, File::Metrics::snapshot(), static_cast<std::uint64_t>(
+                           std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - start).count()));
         }
-        std::vector<char*> arguments{};
-        arguments.assign(argv + 1, argv + argc);
-        file(std::move(arguments));
     } catch (std::exception& e) {
-        std::cerr << e.what() << "Usage: file [files]" << std::endl;
+        std::cerr << e.what() << "Usage: file [-j N] [--files-from FILE] [-0] [--unordered] [--bytes N] [--sample] [--cache PATH] [-r] [--one-file-system] [--follow=never|roots|always] [--daemon SOCKET] [--io-uring] [--stats[=table|json]] [--encodings=LIST] [--shard K/N] [--merge] [--no-cache-pollution[=fadvise|direct]] [--max-read-rate N[K|M|G]] [files | -]" << std::endl;
         return EXIT_FAILURE;
     }
     return EXIT_SUCCESS;
 }
 
-void file(std::vector<char*>&& args) {
-    std::ranges::sort(args);
-    auto last = std::ranges::unique(args, [](const char* a, const char* b) {
-        return std::filesystem::weakly_canonical(a) == std::filesystem::weakly_canonical(b);
-    });
-    args.erase(last.begin(), args.end());
-    std::map<std::filesystem::path, FileState> fileStates{};
-    std::mutex fileStateMutex{};
-    std::vector<std::thread> threads{};
-    threads.reserve(args.size());
-    for (char*& arg: args) {
-        threads.emplace_back([&arg, &fileStateMutex, &fileStates] {
-            const std::filesystem::path path{arg, std::filesystem::path::generic_format};
-            std::optional possibleError{findMetadata(path)};
-            if (possibleError.has_value()) {
-                std::lock_guard guard{fileStateMutex};
-                fileStates.emplace(path, *possibleError);
-                return;
+std::uint64_t parseCount(const std::string_view value, const char* error) {
+    std::uint64_t count{0};
+    for (const char digit: value) {
+        if (digit < '0' || digit > '9' || count > (std::numeric_limits<std::uint64_t>::max() - 9) / 10) {
+            throw std::invalid_argument(error);
+        }
+        count = count * 10 + (digit - '0');
+    }
+    if (value.empty() || count == 0) {
+        throw std::invalid_argument(error);
+    }
+    return count;
+}
+
+EncodingSet parseEncodings(std::string_view value) {
+    constexpr std::array<std::pair<std::string_view, std::uint8_t>, 5> names{
+        {{"ascii", 1}, {"utf16", 2}, {"utf8", 4}, {"latin1", 8}, {"gb", 16}}
+    };
+    constexpr std::array<std::pair<std::uint8_t, EncodingSet>, 6> sets{
+        {
+            {31, EncodingSet::all}, {1, EncodingSet::ascii}, {1 | 4, EncodingSet::utf8},
+            {1 | 2 | 4, EncodingSet::unicode}, {1 | 4 | 8, EncodingSet::western}, {1 | 4 | 16, EncodingSet::chinese}
+        }
+    };
+    std::uint8_t mask{0};
+    while (!value.empty()) {
+        const std::size_t comma{std::min(value.find(','), value.size())};
+        const auto found{std::ranges::find(names, value.substr(0, comma), &std::pair<std::string_view, std::uint8_t>::first)};
+        if (found == names.end()) {
+            throw std::invalid_argument("Unknown encoding. ");
+        }
+        mask |= found->second;
+        value.remove_prefix(std::min(comma + 1, value.size()));
+    }
+    const auto set{std::ranges::find(sets, mask, &std::pair<std::uint8_t, EncodingSet>::first)};
+    if (set == sets.end()) {
+        throw std::invalid_argument(
+            "Unsupported encoding set; choose ascii, ascii,utf8, ascii,utf8,utf16, ascii,utf8,latin1, ascii,utf8,gb "
+            "or all five. ");
+    }
+    return set->second;
+}
+
+std::uint64_t parseRate(std::string_view value) {
+    constexpr std::array<std::pair<char, std::uint64_t>, 3> suffixes{
+        {{'K', 1024}, {'M', 1024 * 1024}, {'G', 1024 * 1024 * 1024}}
+    };
+    std::uint64_t scale{1};
+    if (const auto suffix{std::ranges::find(suffixes, value.empty() ? '\0' : value.back(),
+                                            &std::pair<char, std::uint64_t>::first)}; suffix != suffixes.end()) {
+        scale = suffix->second;
+        value.remove_suffix(1);
+    }
+    const std::uint64_t rate{parseCount(value, "Invalid read rate. ")};
+    if (rate > std::numeric_limits<std::uint64_t>::max() / scale) {
+        throw std::invalid_argument("Invalid read rate. ");
+    }
+    return rate * scale;
+}
+
+File::Io::InputFile::CacheUse parseCacheUse(const std::string_view value) {
+    if (value == "fadvise") {
+        return File::Io::InputFile::CacheUse::dropBehind;
+    }
+    if (value == "direct") {
+        return File::Io::InputFile::CacheUse::direct;
+    }
+    throw std::invalid_argument("Invalid cache mode. ");
+}
+
+Shard parseShard(const std::string_view value) {
+    const std::size_t slash{value.find('/')};
+    if (slash == std::string_view::npos) {
+        throw std::invalid_argument("Invalid shard. ");
+    }
+    const Shard shard{
+        parseCount(value.substr(0, slash), "Invalid shard. "), parseCount(value.substr(slash + 1), "Invalid shard. ")
+    };
+    if (shard.index > shard.count) {
+        throw std::invalid_argument("Invalid shard. ");
+    }
+    return shard;
+}
+
+StatsFormat parseStatsFormat(const std::string_view value) {
+    if (value == "table") {
+        return StatsFormat::table;
+    }
+    if (value == "json") {
+        return StatsFormat::json;
+    }
+    throw std::invalid_argument("Invalid statistics format. ");
+}
+
+File::Io::DirectoryWalker::Follow parseFollow(const std::string_view value) {
+    using Follow = File::Io::DirectoryWalker::Follow;
+    if (value == "never") {
+        return Follow::never;
+    }
+    if (value == "roots") {
+        return Follow::roots;
+    }
+    if (value == "always") {
+        return Follow::always;
+    }
+    throw std::invalid_argument("Invalid symbolic link policy. ");
+}
+
+Options parseArguments(const int argc, char* argv[]) {
+    Options options{};
+    bool parsingOptions{true};
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument{argv[i]};
+        if (parsingOptions && argument == "--") {
+            parsingOptions = false;
+        } else if (parsingOptions && argument == "-j") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing thread count. ");
             }
-            const std::uintmax_t fileSize{file_size(path)};
-            if (fileSize == 0) {
-                std::lock_guard guard{fileStateMutex};
-                fileStates.emplace(path, FileType::empty);
-                return;
+            options.threadCount = parseCount(argv[++i], "Invalid thread count. ");
+        } else if (parsingOptions && argument.starts_with("-j")) {
+            options.threadCount = parseCount(argument.substr(2), "Invalid thread count. ");
+        } else if (parsingOptions && argument == "--files-from") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing file list. ");
             }
-            std::ifstream fileBuffer{path, std::ios::binary};
-            if (!fileBuffer.is_open()) {
-                std::lock_guard guard{fileStateMutex};
-                fileStates.emplace(path, FileError::unreadable);
-                return;
+            options.filesFrom.emplace(argv[++i]);
+        } else if (parsingOptions && argument.starts_with("--files-from=")) {
+            options.filesFrom.emplace(argument.substr(std::string_view{"--files-from="}.size()));
+        } else if (parsingOptions && argument == "-0") {
+            options.listDelimiter = '\0';
+        } else if (parsingOptions && argument == "--unordered") {
+            options.unordered = true;
+        } else if (parsingOptions && argument == "--bytes") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing byte count. ");
+            }
+            options.byteLimit = parseCount(argv[++i], "Invalid byte count. ");
+        } else if (parsingOptions && argument.starts_with("--bytes=")) {
+            options.byteLimit = parseCount(argument.substr(std::string_view{"--bytes="}.size()),
+                                           "Invalid byte count. ");
+        } else if (parsingOptions && argument == "--cache") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing cache path. ");
             }
-            FileState fileState{classifyFile(std::move(fileBuffer))};
-            std::lock_guard guard{fileStateMutex};
-            fileStates.emplace(path, fileState);
+            options.cachePath.emplace(argv[++i]);
+        } else if (parsingOptions && argument.starts_with("--cache=")) {
+            options.cachePath.emplace(argument.substr(std::string_view{"--cache="}.size()));
+        } else if (parsingOptions && (argument == "-r" || argument == "--recursive")) {
+            options.isRecursive = true;
+        } else if (parsingOptions && argument == "--shard") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing shard. ");
+            }
+            options.shard = parseShard(argv[++i]);
+        } else if (parsingOptions && argument.starts_with("--shard=")) {
+            options.shard = parseShard(argument.substr(std::string_view{"--shard="}.size()));
+        } else if (parsingOptions && argument == "--no-cache-pollution") {
+            options.readPolicy.cacheUse = File::Io::InputFile::CacheUse::dropBehind;
+        } else if (parsingOptions && argument.starts_with("--no-cache-pollution=")) {
+            options.readPolicy.cacheUse = parseCacheUse(
+                argument.substr(std::string_view{"--no-cache-pollution="}.size()));
+        } else if (parsingOptions && argument == "--max-read-rate") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing read rate. ");
+            }
+            options.readPolicy.bytesPerSecond = parseRate(argv[++i]);
+        } else if (parsingOptions && argument.starts_with("--max-read-rate=")) {
+            options.readPolicy.bytesPerSecond = parseRate(argument.substr(std::string_view{"--max-read-rate="}.size()));
+        } else if (parsingOptions && argument == "--merge") {
+            options.isMerging = true;
+        } else if (parsingOptions && argument.starts_with("--encodings=")) {
+            options.encodings = parseEncodings(argument.substr(std::string_view{"--encodings="}.size()));
+        } else if (parsingOptions && argument == "--stats") {
+            options.stats = StatsFormat::table;
+        } else if (parsingOptions && argument.starts_with("--stats=")) {
+            options.stats = parseStatsFormat(argument.substr(std::string_view{"--stats="}.size()));
+        } else if (parsingOptions && argument == "--io-uring") {
+            options.useIoUring = true;
+        } else if (parsingOptions && argument == "--one-file-system") {
+            options.isOneFileSystem = true;
+        } else if (parsingOptions && argument.starts_with("--follow=")) {
+            options.follow = parseFollow(argument.substr(std::string_view{"--follow="}.size()));
+        } else if (parsingOptions && argument == "--daemon") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing socket path. ");
+            }
+            options.daemonSocket.emplace(argv[++i]);
+        } else if (parsingOptions && argument.starts_with("--daemon=")) {
+            options.daemonSocket.emplace(argument.substr(std::string_view{"--daemon="}.size()));
+        } else if (parsingOptions && argument == "--sample") {
+            options.sample = true;
+        } else {
+            options.paths.emplace_back(argv[i]);
+        }
+    }
+    if (options.sample && options.byteLimit == std::numeric_limits<std::uint64_t>::max()) {
+        options.byteLimit = defaultSampleBytes;
+    }
+    // Sampling, the cache and the daemon work with verdicts over every encoding.
+    if (options.encodings != EncodingSet::all &&
+        (options.sample || options.cachePath.has_value() || options.daemonSocket.has_value())) {
+        throw std::invalid_argument("--encodings cannot be combined with --sample, --cache or --daemon. ");
+    }
+    if (options.isMerging &&
+        (options.shard.has_value() || options.filesFrom.has_value() || options.daemonSocket.has_value())) {
+        throw std::invalid_argument("--merge only takes shard outputs. ");
+    }
+    if (options.daemonSocket.has_value()) {
+        if (!options.paths.empty() || options.filesFrom.has_value()) {
+            throw std::invalid_argument("The daemon takes its paths from clients. ");
+        }
+        return options;
+    }
+    if (options.paths.empty() && !options.filesFrom.has_value()) {
+        throw std::invalid_argument("Invalid number of arguments. ");
+    }
+    if (options.filesFrom == "-" && std::ranges::any_of(options.paths, [](const char* path) {
+        return std::string_view{path} == "-";
+    })) {
+        throw std::invalid_argument("Standard input cannot be both the file list and a file. ");
+    }
+    return options;
+}
+
+void file(Options&& options) {
+    // Command-line paths are reported sorted by the name they are printed under.
+    std::vector<std::pair<std::filesystem::path, char*>> args{};
+    {
+        const File::Metrics::Timer timer{File::Metrics::Phase::deduplicate};
+        args.reserve(options.paths.size());
+        for (char* arg: options.paths) {
+            args.emplace_back(displayPath(arg), arg);
+        }
+        std::ranges::sort(args);
+        auto last = std::ranges::unique(args, {}, &std::pair<std::filesystem::path, char*>::first);
+        args.erase(last.begin(), args.end());
+    }
+    Pipeline pipeline{options};
+    for (char* arg: args | std::views::values) {
+        pipeline.submit(std::filesystem::path{arg, std::filesystem::path::generic_format});
+    }
+    if (options.filesFrom.has_value()) {
+        std::optional list{
+            options.filesFrom == "-"
+                ? File::Io::DelimitedReader::standardInput(options.listDelimiter)
+                : File::Io::DelimitedReader::open(*options.filesFrom, options.listDelimiter)
+        };
+        if (!list.has_value()) {
+            throw std::runtime_error("Unable to read file list. ");
+        }
+        // Listed paths are reported in list order; sorting them would mean holding the whole list.
+        // Only the command line names standard input; a listed "-" is a file in the working directory.
+        for (std::optional entry{list->next()}; entry.has_value(); entry = list->next()) {
+            pipeline.submit(*entry == "-" ? std::filesystem::path{"./-"}
+                                          : std::filesystem::path{*entry, std::filesystem::path::generic_format});
+        }
+    }
+    pipeline.finish();
+}
+
+Pipeline::Pipeline(const Options& options) : m_options{options},
+                                             m_cache{openCache(options)},
+                                             m_pool{options.threadCount},
+                                             m_queueLimit{m_pool.size() * queuedTasksPerThread},
+                                             m_sink{STDOUT_FILENO},
+                                             m_results{m_sink, m_queueLimit, !options.unordered},
+                                             m_firstNames{m_results},
+                                             m_walker{m_pool, options.follow, options.isOneFileSystem},
+                                             m_sequence{0} {
+    // Sampling maps whole files and the scanner classifies with every encoding through its own reads, which
+    // the read policy does not reach, so all three use the pool.
+    const bool isDefaultReadPolicy{
+        options.readPolicy.cacheUse == File::Io::InputFile::CacheUse::keep && options.readPolicy.bytesPerSecond == 0
+    };
+    if (options.useIoUring && !options.sample && options.encodings == EncodingSet::all && isDefaultReadPolicy) {
+        m_scanner = File::Io::UringScanner::create(std::max<std::size_t>(1, m_pool.size() / 4));
+    }
+    if (options.shard.has_value()) {
+        m_isWalked = [this](const std::filesystem::path& path) {
+            return isInShard(m_options.shard, path);
+        };
+    }
+}
+
+void Pipeline::submit(std::filesystem::path&& path) {
+    // Directories walked recursively are split between shards by their children, everything else by its own
+    // path.
+    if ((!m_options.isRecursive || path == "-") && !isInShard(m_options.shard, path)) {
+        return;
+    }
+    if (path == "-") {
+        enqueue(std::move(path), std::nullopt);
+        return;
+    }
+    // Without directories to find, even the stat is left to the scanner.
+    if (m_scanner != nullptr && !m_options.isRecursive) {
+        scan(std::move(path), false);
+        return;
+    }
+    struct stat metadata{};
+    std::optional<FileState> known{findMetadata(path, metadata)};
+    // A path that vanishes between the two lookups is left for the walker to report.
+    std::error_code linkError{};
+    if (m_options.isRecursive && S_ISDIR(metadata.st_mode) &&
+        (m_options.follow != File::Io::DirectoryWalker::Follow::never || !is_symlink(path, linkError))) {
+        m_walker.walk(path, [this](File::Io::DirectoryWalker::Entry&& entry) {
+            onEntry(std::move(entry));
+        }, m_isWalked);
+        return;
+    }
+    if (m_options.isRecursive && !isInShard(m_options.shard, path)) {
+        return;
+    }
+    if (!known.has_value() && !m_firstNames.isFirst({metadata.st_dev, metadata.st_ino})) {
+        return;
+    }
+    const File::ResultCache::Key key{cacheKey(metadata)};
+    if (!known.has_value() && m_cache.has_value()) {
+        known = m_cache->find(key);
+    }
+    if (known.has_value()) {
+        report(path, *known);
+        return;
+    }
+    enqueue(std::move(path), key);
+}
+
+void Pipeline::finish() {
+    if (m_scanner != nullptr) {
+        m_scanner->wait();
+    }
+    m_pool.wait();
+    m_sink.flush();
+}
+
+void Pipeline::record(const std::uint64_t sequence, const std::filesystem::path& path, const FileState state,
+                      const bool isTentative) {
+    std::string line{path.generic_string()};
+    line.append(": ").append(describe(state));
+    if (isTentative) {
+        line.append(" (tentative)");
+    }
+    line.push_back('\n');
+    const File::Metrics::Timer timer{File::Metrics::Phase::output};
+    m_firstNames.complete(sequence, std::move(line));
+}
+
+void Pipeline::remember(const File::ResultCache::Key& key, const FileState state) {
+    if (m_cache.has_value() && std::holds_alternative<FileType>(state)) {
+        m_cache->insert(key, std::get<FileType>(state));
+    }
+}
+
+void Pipeline::report(const std::filesystem::path& path, const FileState state) {
+    {
+        const File::Metrics::Timer timer{File::Metrics::Phase::backpressure};
+        m_results.waitForSlot(m_sequence);
+    }
+    record(m_sequence++, path, state);
+}
+
+void Pipeline::onEntry(File::Io::DirectoryWalker::Entry&& entry) {
+    if (entry.error != 0) {
+        report(entry.path, entry.error == EACCES ? FileError::unreadable : FileError::metadataError);
+        return;
+    }
+    if (!m_firstNames.isFirst({entry.device, entry.inode})) {
+        return;
+    }
+    if (m_scanner != nullptr) {
+        scan(std::move(entry.path), true);
+    } else {
+        enqueue(std::move(entry.path), std::nullopt);
+    }
+}
+
+void Pipeline::enqueue(std::filesystem::path&& path, const std::optional<File::ResultCache::Key> knownKey) {
+    // Both bounds keep memory flat however many paths are queued.
+    {
+        const File::Metrics::Timer timer{File::Metrics::Phase::backpressure};
+        m_results.waitForSlot(m_sequence);
+        m_pool.waitForCapacity(m_queueLimit);
+    }
+    m_pool.submit([this, path = std::move(path), knownKey, sequence = m_sequence++] {
+        classifyQueued(path, knownKey, sequence);
+    });
+}
+
+void Pipeline::classifyQueued(const std::filesystem::path& path, const std::optional<File::ResultCache::Key> knownKey,
+                              const std::uint64_t sequence) {
+    if (path == "-") {
+        std::optional input{File::Io::InputFile::standardInput()};
+        if (!input.has_value()) {
+            record(sequence, standardInputName, FileError::unreadable);
+            return;
+        }
+        const auto [state, isTentative]{classifyFile(std::move(*input), m_options.byteLimit, m_options.encodings)};
+        record(sequence, standardInputName, state, isTentative);
+        return;
+    }
+    if (knownKey.has_value() && knownKey->size == 0) {
+        record(sequence, path, FileType::empty);
+        return;
+    }
+    std::optional input{File::Io::InputFile::open(path)};
+    if (!input.has_value()) {
+        record(sequence, path, FileError::unreadable);
+        return;
+    }
+    // Files found by walking a directory have not been stat'ed; the open descriptor stands in.
+    const File::ResultCache::Key key{knownKey.value_or(cacheKey(input->metadata()))};
+    if (!knownKey.has_value()) {
+        std::optional<FileState> known{checkMetadata(input->metadata())};
+        if (!known.has_value() && key.size == 0) {
+            known = FileType::empty;
+        }
+        if (!known.has_value() && m_cache.has_value()) {
+            known = m_cache->find(key);
+        }
+        if (known.has_value()) {
+            record(sequence, path, *known);
+            return;
+        }
+    }
+    if (key.size > m_options.byteLimit) {
+        const auto [state, isTentative]{
+            m_options.sample && input->isMapped()
+                ? classifySample(std::move(*input), m_options.byteLimit)
+                : classifyFile(std::move(*input), m_options.byteLimit, m_options.encodings)
+        };
+        if (!isTentative) {
+            remember(key, state);
+        }
+        record(sequence, path, state, isTentative);
+        return;
+    }
+    // Chunk summaries track every encoding, so narrower sets classify large files on one thread.
+    if (input->isMapped() && key.size >= parallelThreshold && m_pool.size() > 1 &&
+        m_options.encodings == EncodingSet::all) {
+        classifyInParallel(m_pool, std::move(*input), [this, key, sequence, path](const FileState state) {
+            remember(key, state);
+            record(sequence, path, state);
+        });
+        return;
+    }
+    const FileState state{classifyFile(std::move(*input), m_options.byteLimit, m_options.encodings).state};
+    remember(key, state);
+    record(sequence, path, state);
+}
+
+void Pipeline::scan(std::filesystem::path&& path, const bool isDeduplicated) {
+    {
+        const File::Metrics::Timer timer{File::Metrics::Phase::backpressure};
+        m_results.waitForSlot(m_sequence);
+        m_scanner->waitForCapacity(m_queueLimit);
+    }
+    const std::uint64_t sequence{m_sequence++};
+    // Metadata arrives in completion order, so which name of a file comes first is left to m_firstNames.
+    if (!isDeduplicated) {
+        m_firstNames.expect(sequence);
+    }
+    File::Io::UringScanner::MetadataCheck onMetadata{
+        [this, path, sequence, isDeduplicated](const int error, const struct statx& metadata) {
+            return checkScanned(path, sequence, isDeduplicated, error, metadata);
+        }
+    };
+    File::Io::UringScanner::Completion onFinished{
+        [this, path, sequence](File::Io::UringScanner::Outcome&& outcome) {
+            finishScanned(path, sequence, std::move(outcome));
+        }
+    };
+    m_scanner->submit({std::move(path), m_options.byteLimit, std::move(onMetadata), std::move(onFinished)});
+}
+
+bool Pipeline::checkScanned(const std::filesystem::path& path, const std::uint64_t sequence,
+                            const bool isDeduplicated, const int error, const struct statx& metadata) {
+    const struct stat status{statusOf(metadata)};
+    const std::optional problem{error != 0 ? std::make_optional(metadataErrorOf(error)) : checkMetadata(status)};
+    // A name without a readable regular file behind it has nothing to share with another.
+    const std::optional<File::Io::FileIdentity> identity{
+        problem.has_value() ? std::nullopt : std::make_optional<File::Io::FileIdentity>(status.st_dev, status.st_ino)
+    };
+    if (!isDeduplicated && !m_firstNames.identify(sequence, identity)) {
+        return false;
+    }
+    if (problem.has_value()) {
+        record(sequence, path, *problem);
+        return false;
+    }
+    const File::ResultCache::Key key{cacheKey(status)};
+    std::optional<FileState> known{};
+    if (key.size == 0) {
+        known = FileType::empty;
+    } else if (m_cache.has_value()) {
+        known = m_cache->find(key);
+    }
+    if (known.has_value()) {
+        record(sequence, path, *known);
+        return false;
+    }
+    // Large files are split between pool threads, which one scanner thread reading them could not match.
+    if (key.size >= parallelThreshold && key.size <= m_options.byteLimit && m_pool.size() > 1) {
+        m_pool.submit([this, path, key, sequence] {
+            classifyQueued(path, key, sequence);
         });
+        return false;
+    }
+    return true;
+}
+
+void Pipeline::finishScanned(const std::filesystem::path& path, const std::uint64_t sequence,
+                             File::Io::UringScanner::Outcome&& outcome) {
+    if (outcome.error != 0) {
+        record(sequence, path, FileError::unreadable);
+        return;
+    }
+    const bool isTentative{outcome.isTruncated && outcome.type != FileType::data};
+    if (!isTentative) {
+        remember(cacheKey(statusOf(outcome.metadata)), outcome.type);
     }
-    for (std::thread& thread: threads) {
-        thread.join();
-    }
-    for (auto [path, result]: fileStates) {
-        std::string message;
-        if (std::holds_alternative<FileType>(result)) {
-            switch (std::get<FileType>(result)) {
-                case FileType::empty:
-                    message = "empty";
-                    break;
-                case FileType::ascii:
-                    message = "ASCII text";
-                    break;
-                case FileType::latin1:
-                    message = "ISO-8859-1 text";
-                    break;
-                case FileType::utf8:
-                    message = "UTF-8 text";
-                    break;
-                case FileType::utf16:
-                    message = "UTF-16 text";
-                    break;
-                case FileType::gb:
-                    message = "GB 18030 text";
-                    break;
-                case FileType::data:
-                    message = "data";
-                    break;
+    record(sequence, path, outcome.type, isTentative);
+}
+
+void serve(Options&& options) {
+    std::optional cache{openCache(options)};
+    File::WorkStealingPool pool{options.threadCount};
+    std::optional server{
+        File::Daemon::Server::listen(*options.daemonSocket, pool, [&cache](const File::Daemon::RequestKind kind,
+                                                                          const std::span<const std::uint8_t> payload) {
+            return classifyRequest(kind, payload, cache.has_value() ? &*cache : nullptr);
+        })
+    };
+    if (!server.has_value() && errno == EADDRINUSE) {
+        throw std::runtime_error("Another daemon is already listening on socket. ");
+    }
+    if (!server.has_value()) {
+        throw std::runtime_error("Unable to listen on socket. ");
+    }
+    runningServer = &*server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    server->run();
+    runningServer = nullptr;
+}
+
+void merge(Options&& options) {
+    struct Source {
+        File::Io::DelimitedReader reader;
+        std::string line;
+        std::filesystem::path path;
+
+        // Lines read "path: description" and descriptions never contain ": ", so the last one ends the path.
+        // Shards given --files-from or --unordered print out of path order, which a merge would scramble.
+        bool advance() {
+            const std::optional record{reader.next()};
+            if (!record.has_value()) {
+                return false;
             }
-        } else {
-            switch (std::get<FileError>(result)) {
-                case FileError::metadataError:
-                    message = "Was unable to check status of file";
-                    break;
-                case FileError::doesNotExist:
-                    message = "File does not exist";
-                    break;
-                case FileError::invalidPerms:
-                    message = "Invalid permissions";
-                    break;
-                case FileError::notRegularFile:
-                    message = "File is not a regular file";
-                    break;
-                case FileError::unreadable:
-                    message = "Lacked read permissions";
+            line.assign(*record);
+            std::filesystem::path next{line.substr(0, line.rfind(": ")), std::filesystem::path::generic_format};
+            if (next < path) {
+                throw std::runtime_error("Shard output is not sorted by path; shards to merge cannot be run with "
+                                         "--files-from or --unordered. ");
             }
+            path = std::move(next);
+            return true;
         }
-        std::cout << path.generic_string() << ": " << message << "\n";
-    }
-    std::flush(std::cout);
-}
-
-constexpr bool isByteAscii(const std::uint8_t byte) {
-    return (0x08 <= byte && byte <= 0x0D) || (byte == 0x1B) | (0x20 <= byte && byte <= 0x7E);
-}
-
-constexpr bool isByteLatin1(const std::uint8_t byte) {
-    return isByteAscii(byte) || byte >= 0xA0;
-}
-
-FileState classifyFile(std::ifstream&& fileReader) {
-    using namespace File;
-    bool isAscii{true}, isLatin1{true}, isUtf8{true}, isUtf16{true}, isGb{true};
-    std::optional<Unicode::Utf8Sequence> utf8Sequence{std::nullopt};
-    std::optional<Unicode::Utf16Sequence> utf16Sequence{std::nullopt};
-    std::optional<GbSequence> gbSequence{std::nullopt};
-    std::optional<Unicode::Endianness> endianness{std::nullopt};
-    std::array<std::uint8_t, 2> byteBuffer{0, 0};
-    std::uintmax_t bytesRead{0};
-    std::uint8_t byte;
-    fileReader.get(reinterpret_cast<char&>(byte));
-    while (fileReader.good()) {
-        bytesRead++;
-        if (isAscii && !isByteAscii(byte)) {
-            isAscii = false;
-        }
-        if (!isAscii && isUtf16) {
-            byteBuffer[(bytesRead - 1) % 2] = byte;
-            if (bytesRead % 2 == 0) {
-                if (endianness.has_value()) {
-                    const std::uint16_t point = [&] {
-                        switch (endianness.value()) {
-                            case Unicode::Endianness::bigEndian:
-                                return byteBuffer[0] << 8 | byteBuffer[1];
-                            case Unicode::Endianness::littleEndian:
-                                return byteBuffer[1] << 8 | byteBuffer[0];
-                        }
-                        return 0;
-                    }();
-                    validateVle<std::uint16_t, Unicode::Utf16Sequence>(
-                        isUtf16, utf16Sequence, point);
-                } else {
-                    const std::uint16_t bigEndian{
-                        static_cast<std::uint16_t>(byteBuffer[0] << 8 | byteBuffer[1])
-                    };
-                    const std::uint16_t littleEndian{
-                        static_cast<std::uint16_t>(byteBuffer[1] << 8 | byteBuffer[0])
-                    };
-                    if (bigEndian == 0xFEFF) {
-                        endianness = Unicode::Endianness::bigEndian;
-                    } else if (littleEndian == 0xFEFF) {
-                        endianness = Unicode::Endianness::littleEndian;
-                    } else {
-                        isUtf16 = false;;
-                    }
-                }
-            }
+    };
+    std::vector<Source> sources{};
+    sources.reserve(options.paths.size());
+    for (const char* arg: options.paths) {
+        std::optional reader{
+            std::string_view{arg} == "-"
+                ? File::Io::DelimitedReader::standardInput('\n')
+                : File::Io::DelimitedReader::open(arg, '\n')
+        };
+        if (!reader.has_value()) {
+            throw std::runtime_error("Unable to read shard output. ");
         }
-        if (!isAscii && isUtf8) {
-            validateVle<std::uint8_t, Unicode::Utf8Sequence>(isUtf8, utf8Sequence, byte);
+        sources.emplace_back(std::move(*reader));
+    }
+    // Ties go to the earlier source, so merging is deterministic.
+    auto isLater{
+        [&sources](const std::size_t left, const std::size_t right) {
+            const int order{sources[left].path.compare(sources[right].path)};
+            return order > 0 || (order == 0 && left > right);
         }
-        if (!isAscii && isGb) {
-            validateVle<std::uint8_t, GbSequence>(isGb, gbSequence, byte);
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(isLater)> heads{isLater};
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        if (sources[i].advance()) {
+            heads.push(i);
         }
-        if (!isAscii && isLatin1 && !isByteLatin1(byte)) {
-            isLatin1 = false;
+    }
+    File::Io::OutputSink sink{STDOUT_FILENO};
+    while (!heads.empty()) {
+        const std::size_t next{heads.top()};
+        heads.pop();
+        sink.append(sources[next].line);
+        sink.append("\n");
+        if (sources[next].advance()) {
+            heads.push(next);
         }
-        if (!isAscii && !isUtf16 && !isUtf8 && !isGb && !isLatin1) {
-            return FileType::data;
+    }
+    sink.flush();
+}
+
+void stopServer(int) {
+    if (runningServer != nullptr) {
+        runningServer->stop();
+    }
+}
+
+std::optional<File::ResultCache> openCache(const Options& options) {
+    if (!options.cachePath.has_value()) {
+        return std::nullopt;
+    }
+    std::optional cache{File::ResultCache::open(*options.cachePath)};
+    if (!cache.has_value() && errno == EWOULDBLOCK) {
+        std::cerr << "file: " << *options.cachePath
+                  << " is in use by another process; continuing without the cache." << std::endl;
+        return std::nullopt;
+    }
+    if (!cache.has_value()) {
+        throw std::runtime_error("Unable to open cache. ");
+    }
+    return cache;
+}
+
+FileState classifyRequest(const File::Daemon::RequestKind kind, const std::span<const std::uint8_t> payload,
+                          File::ResultCache* cache) {
+    if (kind == File::Daemon::RequestKind::bytes) {
+        File::Classifier classifier{};
+        classifier.feed(payload);
+        return classifier.finish();
+    }
+    const std::filesystem::path path{
+        std::string_view{reinterpret_cast<const char*>(payload.data()), payload.size()},
+        std::filesystem::path::generic_format
+    };
+    struct stat metadata{};
+    if (const std::optional error{findMetadata(path, metadata)}) {
+        return *error;
+    }
+    if (metadata.st_size == 0) {
+        return FileType::empty;
+    }
+    const File::ResultCache::Key key{cacheKey(metadata)};
+    if (cache != nullptr) {
+        if (const std::optional cached{cache->find(key)}) {
+            return *cached;
         }
-        fileReader.get(reinterpret_cast<char&>(byte));
     }
-    if (utf16Sequence.has_value()) {
-        isUtf16 = false;
+    std::optional input{File::Io::InputFile::open(path)};
+    if (!input.has_value()) {
+        return FileError::unreadable;
     }
-    if (utf8Sequence.has_value()) {
-        isUtf8 = false;
+    const FileState state{classifyFile(std::move(*input), std::numeric_limits<std::uint64_t>::max()).state};
+    if (cache != nullptr && std::holds_alternative<FileType>(state)) {
+        cache->insert(key, std::get<FileType>(state));
     }
-    if (gbSequence.has_value()) {
-        isGb = false;
+    return state;
+}
+
+void printStats(const StatsFormat format, const File::Metrics::Snapshot& snapshot, const std::uint64_t wallNanos) {
+    using File::Metrics;
+    constexpr std::array<std::string_view, Metrics::phaseCount> phaseNames{
+        "deduplicate", "metadata", "open", "scan", "cache", "output", "backpressure"
+    };
+    constexpr std::array<std::string_view, Metrics::candidateCount> candidateNames{
+        "ascii", "utf16", "utf8", "latin1", "gb"
+    };
+    timespec processCpu{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &processCpu);
+    const auto milliseconds{[](const std::uint64_t nanos) { return static_cast<double>(nanos) / 1e6; }};
+    const double cpuMilliseconds{static_cast<double>(processCpu.tv_sec) * 1e3 +
+                                 static_cast<double>(processCpu.tv_nsec) / 1e6};
+    const auto meanOffset{
+        [](const Metrics::CandidateTotals& totals) {
+            return totals.eliminations == 0
+                       ? 0.0
+                       : static_cast<double>(totals.eliminationOffsetTotal) / static_cast<double>(totals.eliminations);
+        }
+    };
+    // Statistics go to standard error so they never mix with the verdicts.
+    std::ostream& out{std::cerr};
+    out << std::fixed << std::setprecision(3);
+    if (format == StatsFormat::json) {
+        out << "{\"wall_ms\":" << milliseconds(wallNanos) << ",\"cpu_ms\":" << cpuMilliseconds
+            << ",\"threads\":" << snapshot.threads << ",\"phases\":{";
+        for (std::size_t i = 0; i < Metrics::phaseCount; i++) {
+            const Metrics::PhaseTotals& phase{snapshot.phases[i]};
+            out << (i == 0 ? "" : ",") << '"' << phaseNames[i] << "\":{\"calls\":" << phase.count
+                << ",\"wall_ms\":" << milliseconds(phase.wallNanos) << ",\"cpu_ms\":" << milliseconds(phase.cpuNanos)
+                << '}';
+        }
+        out << "},\"candidates\":{";
+        for (std::size_t i = 0; i < Metrics::candidateCount; i++) {
+            const Metrics::CandidateTotals& candidate{snapshot.candidates[i]};
+            out << (i == 0 ? "" : ",") << '"' << candidateNames[i] << "\":{\"bytes_scanned\":"
+                << candidate.bytesScanned << ",\"eliminated\":" << candidate.eliminations
+                << ",\"mean_elimination_offset\":" << meanOffset(candidate)
+                << ",\"max_elimination_offset\":" << candidate.eliminationOffsetMaximum << '}';
+        }
+        out << "},\"files_classified\":" << snapshot.filesClassified << ",\"early_exits\":" << snapshot.earlyExits
+            << ",\"lock_waits\":" << snapshot.lockWaits << ",\"lock_wait_ms\":"
+            << milliseconds(snapshot.lockWaitNanos) << '}' << std::endl;
+        return;
     }
-    if (isAscii) {
-        return FileType::ascii;
+    out << std::left << std::setw(14) << "phase" << std::right << std::setw(12) << "calls" << std::setw(14)
+        << "wall ms" << std::setw(14) << "cpu ms" << '\n';
+    for (std::size_t i = 0; i < Metrics::phaseCount; i++) {
+        const Metrics::PhaseTotals& phase{snapshot.phases[i]};
+        out << std::left << std::setw(14) << phaseNames[i] << std::right << std::setw(12) << phase.count
+            << std::setw(14) << milliseconds(phase.wallNanos) << std::setw(14) << milliseconds(phase.cpuNanos) << '\n';
     }
-    if (isUtf16) {
-        return FileType::utf16;
+    out << '\n' << std::left << std::setw(14) << "candidate" << std::right << std::setw(16) << "bytes scanned"
+        << std::setw(12) << "eliminated" << std::setw(16) << "mean offset" << std::setw(16) << "max offset" << '\n';
+    for (std::size_t i = 0; i < Metrics::candidateCount; i++) {
+        const Metrics::CandidateTotals& candidate{snapshot.candidates[i]};
+        out << std::left << std::setw(14) << candidateNames[i] << std::right << std::setw(16)
+            << candidate.bytesScanned << std::setw(12) << candidate.eliminations << std::setw(16)
+            << meanOffset(candidate) << std::setw(16) << candidate.eliminationOffsetMaximum << '\n';
     }
-    if (isUtf8) {
-        return FileType::utf8;
+    out << "\nfiles classified " << snapshot.filesClassified << ", early exits " << snapshot.earlyExits
+        << "\nlock waits " << snapshot.lockWaits << ", " << milliseconds(snapshot.lockWaitNanos) << " ms"
+        << "\nthreads " << snapshot.threads << ", wall " << milliseconds(wallNanos) << " ms, cpu "
+        << cpuMilliseconds << " ms" << std::endl;
+}
+
+bool isInShard(const std::optional<Shard>& shard, const std::filesystem::path& path) noexcept {
+    if (!shard.has_value()) {
+        return true;
     }
-    if (isLatin1) {
-        return FileType::latin1;
+    // FNV-1a over the path as given, so every node agrees without sharing anything but the command line.
+    std::uint64_t hash{0xCBF29CE484222325};
+    for (const char c: path.native()) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3;
     }
-    if (isGb) {
-        return FileType::gb;
+    return hash % shard->count == shard->index - 1;
+}
+
+std::filesystem::path displayPath(const char* arg) {
+    if (std::string_view{arg} == "-") {
+        return standardInputName;
     }
-    return FileType::data;
+    return std::filesystem::path{arg, std::filesystem::path::generic_format};
 }
 
+std::string_view describe(const FileState state) {
+    if (std::holds_alternative<FileType>(state)) {
+        switch (std::get<FileType>(state)) {
+            case FileType::empty:
+                return "empty";
+            case FileType::ascii:
+                return "ASCII text";
+            case FileType::latin1:
+                return "ISO-8859-1 text";
+            case FileType::utf8:
+                return "UTF-8 text";
+            case FileType::utf16:
+                return "UTF-16 text";
+            case FileType::gb:
+                return "GB 18030 text";
+            case FileType::data:
+                return "data";
+        }
+    } else {
+        switch (std::get<FileError>(state)) {
+            case FileError::metadataError:
+                return "Was unable to check status of file";
+            case FileError::doesNotExist:
+                return "File does not exist";
+            case FileError::invalidPerms:
+                return "Invalid permissions";
+            case FileError::notRegularFile:
+                return "File is not a regular file";
+            case FileError::unreadable:
+                return "Lacked read permissions";
+        }
+    }
+    return {};
+}
 
-std::optional<FileError> findMetadata(const std::filesystem::path& path) noexcept {
-    namespace fs = std::filesystem;
-    std::error_code ec{};
-    const fs::file_status metadata{status(path, ec)};
-    if (!status_known(metadata)) {
-        return std::make_optional(FileError::metadataError);
+Verdict classifyFile(File::Io::InputFile&& input, const std::uint64_t byteLimit, const EncodingSet encodings) {
+    switch (encodings) {
+        case EncodingSet::ascii:
+            return classifyWith<File::AsciiClassifier>(std::move(input), byteLimit);
+        case EncodingSet::utf8:
+            return classifyWith<File::Utf8Classifier>(std::move(input), byteLimit);
+        case EncodingSet::unicode:
+            return classifyWith<File::UnicodeClassifier>(std::move(input), byteLimit);
+        case EncodingSet::western:
+            return classifyWith<File::WesternClassifier>(std::move(input), byteLimit);
+        case EncodingSet::chinese:
+            return classifyWith<File::ChineseClassifier>(std::move(input), byteLimit);
+        case EncodingSet::all:
+            break;
     }
-    if (!exists(metadata)) {
-        return std::make_optional(FileError::doesNotExist);
+    return classifyWith<File::Classifier>(std::move(input), byteLimit);
+}
+
+template<class Classifier>
+Verdict classifyWith(File::Io::InputFile&& input, const std::uint64_t byteLimit) {
+    const File::Metrics::Timer timer{File::Metrics::Phase::scan};
+    Classifier classifier{};
+    std::uint64_t remaining{byteLimit};
+    bool isTruncated{false};
+    for (std::span block{input.next()}; !block.empty() && !classifier.isDecided(); block = input.next()) {
+        if (remaining == 0) {
+            isTruncated = true;
+            break;
+        }
+        isTruncated = block.size() > remaining;
+        block = block.first(std::min<std::uint64_t>(block.size(), remaining));
+        classifier.feed(block);
+        remaining -= block.size();
+        if (isTruncated) {
+            break;
+        }
     }
-    if (metadata.type() == fs::file_type::unknown) {
-        return std::make_optional(FileError::invalidPerms);
+    File::Metrics::addClassified(classifier.isDecided() &&
+                                 classifier.bytesScanned() < static_cast<std::uint64_t>(input.metadata().st_size));
+    if (!input.isIntact()) {
+        return {FileError::unreadable, false};
     }
-    if (!is_regular_file(metadata)) {
+    if (!isTruncated) {
+        return {classifier.finish(), false};
+    }
+    const FileType type{classifier.provisional()};
+    return {type, type != FileType::data};
+}
+
+Verdict classifySample(File::Io::InputFile&& input, const std::uint64_t byteBudget) {
+    const File::Metrics::Timer timer{File::Metrics::Phase::scan};
+    File::Metrics::addClassified(false);
+    const std::span bytes{input.next()};
+    // Windows start at even offsets so UTF-16 code units are never split at a window's start.
+    std::size_t window{std::max<std::size_t>(byteBudget / sampleWindows, 2)};
+    window += window % 2;
+    if (window * sampleWindows >= bytes.size()) {
+        File::Classifier classifier{};
+        classifier.feed(bytes);
+        return {input.isIntact() ? FileState{classifier.finish()} : FileError::unreadable, false};
+    }
+    const std::size_t stride{(bytes.size() - window) / (sampleWindows - 1) & ~std::size_t{1}};
+    const File::ChunkSummary head{File::ChunkSummary::summarize(bytes.first(window))};
+    recordEliminations(File::ChunkSummary{}.candidates(), head, window);
+    File::ChunkSummary summary{head};
+    for (std::size_t i = 1; i < sampleWindows && summary.hasCandidates(); i++) {
+        const std::array wasCandidate{summary.candidates()};
+        summary.appendAfterGap(File::ChunkSummary::summarize(bytes.subspan(i * stride, window), head));
+        recordEliminations(wasCandidate, summary, i * stride + window);
+    }
+    if (!input.isIntact()) {
+        return {FileError::unreadable, false};
+    }
+    const FileType type{summary.provisionalVerdict()};
+    return {type, type != FileType::data};
+}
+
+void classifyInParallel(File::WorkStealingPool& pool, File::Io::InputFile&& input,
+                        std::function<void(FileState)> onVerdict) {
+    struct Job {
+        File::Io::InputFile input;
+        std::span<const std::uint8_t> bytes;
+        std::size_t chunkSize;
+        File::ChunkSummary head;
+        std::vector<File::ChunkSummary> summaries;
+        std::atomic<std::size_t> remaining;
+        std::function<void(FileState)> onVerdict;
+    };
+    const std::span bytes{input.next()};
+    // Chunks start at even offsets so UTF-16 code units never straddle two of them.
+    std::size_t chunkSize{std::max(minimumChunkSize, bytes.size() / (pool.size() * 4))};
+    chunkSize += chunkSize % 2;
+    const std::size_t chunkCount{(bytes.size() + chunkSize - 1) / chunkSize};
+    // The first chunk is summarised in place so the others only track encodings that are still possible.
+    File::ChunkSummary head{};
+    {
+        const File::Metrics::Timer timer{File::Metrics::Phase::scan};
+        head = File::ChunkSummary::summarize(bytes.first(std::min(chunkSize, bytes.size())));
+    }
+    recordEliminations(File::ChunkSummary{}.candidates(), head, std::min(chunkSize, bytes.size()));
+    if (chunkCount == 1 || !head.hasCandidates()) {
+        File::Metrics::addClassified(chunkCount > 1);
+        onVerdict(input.isIntact() ? FileState{head.verdict()} : FileError::unreadable);
+        return;
+    }
+    auto job{
+        std::make_shared<Job>(std::move(input), bytes, chunkSize, head,
+                              std::vector<File::ChunkSummary>(chunkCount - 1), chunkCount - 1, std::move(onVerdict))
+    };
+    for (std::size_t i = 1; i < chunkCount; i++) {
+        pool.submit([job, i] {
+            const std::size_t offset{i * job->chunkSize};
+            {
+                const File::Metrics::Timer timer{File::Metrics::Phase::scan};
+                job->summaries[i - 1] = File::ChunkSummary::summarize(
+                    job->bytes.subspan(offset, std::min(job->chunkSize, job->bytes.size() - offset)), job->head);
+            }
+            if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+            File::Metrics::addClassified(false);
+            // Chunks are appended in file order, so each encoding is counted as ruled out where it first fails.
+            File::ChunkSummary whole{job->head};
+            for (std::size_t chunk = 1; chunk <= job->summaries.size(); chunk++) {
+                const std::array wasCandidate{whole.candidates()};
+                whole.append(job->summaries[chunk - 1]);
+                recordEliminations(wasCandidate, whole, std::min((chunk + 1) * job->chunkSize, job->bytes.size()));
+            }
+            job->onVerdict(job->input.isIntact() ? FileState{whole.verdict()} : FileError::unreadable);
+        });
+    }
+}
+
+// Counts the encodings the chunk last appended to summary ruled out, as the classifier does for each block it
+// is fed; end is where that chunk ends in the file.
+void recordEliminations(const std::array<bool, 5>& wasCandidate, const File::ChunkSummary& summary,
+                        const std::uint64_t end) noexcept {
+    if (!File::Metrics::isEnabled()) {
+        return;
+    }
+    const std::array isCandidate{summary.candidates()};
+    for (std::size_t i = 0; i < isCandidate.size(); i++) {
+        if (wasCandidate[i] && !isCandidate[i]) {
+            File::Metrics::addElimination(static_cast<File::Metrics::Candidate>(i), end);
+        }
+    }
+}
+
+std::optional<FileError> findMetadata(const std::filesystem::path& path, struct stat& metadata) noexcept {
+    const File::Metrics::Timer timer{File::Metrics::Phase::metadata};
+    if (stat(path.c_str(), &metadata) != 0) {
+        return std::make_optional(metadataErrorOf(errno));
+    }
+    return checkMetadata(metadata);
+}
+
+FileError metadataErrorOf(const int error) noexcept {
+    switch (error) {
+        case ENOENT:
+        case ENOTDIR:
+            return FileError::doesNotExist;
+        case EOVERFLOW:
+            return FileError::invalidPerms;
+        default:
+            return FileError::metadataError;
+    }
+}
+
+struct stat statusOf(const struct statx& metadata) noexcept {
+    struct stat status{};
+    status.st_dev = makedev(metadata.stx_dev_major, metadata.stx_dev_minor);
+    status.st_ino = metadata.stx_ino;
+    status.st_mode = metadata.stx_mode;
+    status.st_size = static_cast<off_t>(metadata.stx_size);
+    status.st_mtim.tv_sec = metadata.stx_mtime.tv_sec;
+    status.st_mtim.tv_nsec = metadata.stx_mtime.tv_nsec;
+    return status;
+}
+
+std::optional<FileError> checkMetadata(const struct stat& metadata) noexcept {
+    if (!S_ISREG(metadata.st_mode)) {
         return std::make_optional(FileError::notRegularFile);
     }
-    if ((metadata.permissions() & (fs::perms::owner_read | fs::perms::group_read |
-                                   fs::perms::others_read)) ==
-        fs::perms::none) {
+    if ((metadata.st_mode & (S_IRUSR | S_IRGRP | S_IROTH)) == 0) {
         return std::make_optional(FileError::unreadable);
     }
     return std::nullopt;
 }
 
+File::ResultCache::Key cacheKey(const struct stat& metadata) noexcept {
+    return {
+        static_cast<std::uint64_t>(metadata.st_dev), static_cast<std::uint64_t>(metadata.st_ino),
+        static_cast<std::uint64_t>(metadata.st_size),
+        static_cast<std::int64_t>(metadata.st_mtim.tv_sec) * 1'000'000'000 + metadata.st_mtim.tv_nsec
+    };
+}
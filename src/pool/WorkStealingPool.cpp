@@ -0,0 +1,124 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include "../Metrics.hpp"
+
+namespace File {
+    namespace {
+        thread_local const WorkStealingPool* currentPool{nullptr};
+        thread_local std::size_t currentWorker{0};
+    }
+
+    WorkStealingPool::WorkStealingPool(const std::size_t threadCount) : m_nextWorker{0},
+                                                                       m_queued{0},
+                                                                       m_unfinished{0},
+                                                                       m_stopping{false} {
+        const std::size_t count{std::max<std::size_t>(threadCount, 1)};
+        m_workers.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            m_workers.emplace_back(std::make_unique<Worker>());
+        }
+        m_threads.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            m_threads.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool() {
+        wait();
+        {
+            std::lock_guard guard{m_stateMutex};
+            m_stopping = true;
+        }
+        m_workAvailable.notify_all();
+        for (std::thread& thread: m_threads) {
+            thread.join();
+        }
+    }
+
+    std::size_t WorkStealingPool::defaultThreadCount() noexcept {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    std::size_t WorkStealingPool::size() const noexcept {
+        return m_workers.size();
+    }
+
+    void WorkStealingPool::submit(Task&& task) {
+        // Tasks spawned from inside a worker stay local to it until stolen.
+        const std::size_t index{
+            currentPool == this ? currentWorker : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % size()
+        };
+        {
+            const std::unique_lock lock{Metrics::lock(m_workers[index]->mutex)};
+            m_workers[index]->tasks.emplace_back(std::move(task));
+        }
+        {
+            const std::unique_lock lock{Metrics::lock(m_stateMutex)};
+            m_queued++;
+            m_unfinished++;
+        }
+        m_workAvailable.notify_one();
+    }
+
+    void WorkStealingPool::waitForCapacity(const std::size_t limit) {
+        std::unique_lock lock{m_stateMutex};
+        m_taskFinished.wait(lock, [this, limit] { return m_unfinished < limit; });
+    }
+
+    void WorkStealingPool::wait() {
+        waitForCapacity(1);
+    }
+
+    std::optional<WorkStealingPool::Task> WorkStealingPool::take(const std::size_t index) {
+        {
+            Worker& own{*m_workers[index]};
+            const std::unique_lock lock{Metrics::lock(own.mutex)};
+            if (!own.tasks.empty()) {
+                Task task{std::move(own.tasks.front())};
+                own.tasks.pop_front();
+                return task;
+            }
+        }
+        for (std::size_t offset = 1; offset < size(); offset++) {
+            Worker& victim{*m_workers[(index + offset) % size()]};
+            const std::unique_lock lock{Metrics::lock(victim.mutex)};
+            if (!victim.tasks.empty()) {
+                Task task{std::move(victim.tasks.back())};
+                victim.tasks.pop_back();
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void WorkStealingPool::finishTask() {
+        {
+            const std::unique_lock lock{Metrics::lock(m_stateMutex)};
+            m_unfinished--;
+        }
+        m_taskFinished.notify_all();
+    }
+
+    void WorkStealingPool::run(const std::size_t index) {
+        currentPool = this;
+        currentWorker = index;
+        while (true) {
+            {
+                std::unique_lock lock{m_stateMutex};
+                m_workAvailable.wait(lock, [this] { return m_stopping || m_queued > 0; });
+                if (m_queued == 0) {
+                    return;
+                }
+                m_queued--;
+            }
+            // A queued count was reserved above, so some deque holds a task for us.
+            std::optional<Task> task{take(index)};
+            while (!task.has_value()) {
+                std::this_thread::yield();
+                task = take(index);
+            }
+            (*task)();
+            finishTask();
+        }
+    }
+} // File
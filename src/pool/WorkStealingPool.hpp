@@ -0,0 +1,64 @@
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace File {
+    class WorkStealingPool {
+    public:
+        using Task = std::function<void()>;
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
+        std::atomic<std::size_t> m_nextWorker;
+        std::mutex m_stateMutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_taskFinished;
+        std::size_t m_queued;
+        std::size_t m_unfinished;
+        bool m_stopping;
+
+        void run(std::size_t index);
+
+        std::optional<Task> take(std::size_t index);
+
+        void finishTask();
+
+    public:
+        explicit WorkStealingPool(std::size_t threadCount);
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        ~WorkStealingPool();
+
+        [[nodiscard]] static std::size_t defaultThreadCount() noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        void submit(Task&& task);
+
+        // Blocks until fewer than limit submitted tasks are unfinished, bounding what a producer queues.
+        void waitForCapacity(std::size_t limit);
+
+        void wait();
+    };
+} // File
+
+#endif //WORKSTEALINGPOOL_HPP
@@ -0,0 +1,129 @@
+#include "Ascii.hpp"
+#include <bit>
+#include "../vle/Unicode.hpp"
+#if FILE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace File::Simd {
+    namespace {
+        std::size_t scalarPrefix(const std::uint8_t* data, const std::size_t size, std::size_t offset) noexcept {
+            while (offset < size && data[offset] < 0x80 && Unicode::isText(data[offset])) {
+                offset++;
+            }
+            return offset;
+        }
+
+#if FILE_SIMD_X86
+        __attribute__((target("sse2")))
+        std::uint32_t sse2TextMask(const __m128i bytes) noexcept {
+            // Signed compares: bytes at or above 0x80 are negative and fail every range.
+            const __m128i printable{
+                _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(0x1F)),
+                              _mm_cmplt_epi8(bytes, _mm_set1_epi8(0x7F)))
+            };
+            const __m128i whitespace{
+                _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(0x07)),
+                              _mm_cmplt_epi8(bytes, _mm_set1_epi8(0x0E)))
+            };
+            const __m128i escape{_mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x1B))};
+            return static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(printable, whitespace), escape)));
+        }
+
+        __attribute__((target("sse2")))
+        std::size_t sse2Prefix(const std::uint8_t* data, const std::size_t size) noexcept {
+            std::size_t offset{0};
+            for (; offset + 32 <= size; offset += 32) {
+                const std::uint32_t low{
+                    sse2TextMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset)))
+                };
+                const std::uint32_t high{
+                    sse2TextMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + 16)))
+                };
+                const std::uint32_t mask{low | high << 16};
+                if (mask != 0xFFFFFFFF) {
+                    return offset + std::countr_one(mask);
+                }
+            }
+            return scalarPrefix(data, size, offset);
+        }
+
+        __attribute__((target("avx2")))
+        std::uint32_t avx2TextMask(const __m256i bytes) noexcept {
+            const __m256i printable{
+                _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(0x1F)),
+                                 _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7F), bytes))
+            };
+            const __m256i whitespace{
+                _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(0x07)),
+                                 _mm256_cmpgt_epi8(_mm256_set1_epi8(0x0E), bytes))
+            };
+            const __m256i escape{_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x1B))};
+            return static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(printable, whitespace), escape)));
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t avx2Prefix(const std::uint8_t* data, const std::size_t size) noexcept {
+            std::size_t offset{0};
+            for (; offset + 64 <= size; offset += 64) {
+                const std::uint64_t low{
+                    avx2TextMask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset)))
+                };
+                const std::uint64_t high{
+                    avx2TextMask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + 32)))
+                };
+                const std::uint64_t mask{low | high << 32};
+                if (mask != ~std::uint64_t{0}) {
+                    return offset + std::countr_one(mask);
+                }
+            }
+            return scalarPrefix(data, size, offset);
+        }
+
+        __attribute__((target("avx512f,avx512bw")))
+        std::size_t avx512Prefix(const std::uint8_t* data, const std::size_t size) noexcept {
+            std::size_t offset{0};
+            for (; offset + 64 <= size; offset += 64) {
+                const __m512i bytes{_mm512_loadu_si512(data + offset)};
+                // Unsigned range checks: subtracting the lower bound wraps everything below it upwards.
+                const __mmask64 printable{
+                    _mm512_cmple_epu8_mask(_mm512_sub_epi8(bytes, _mm512_set1_epi8(0x20)),
+                                           _mm512_set1_epi8(0x7E - 0x20))
+                };
+                const __mmask64 whitespace{
+                    _mm512_cmple_epu8_mask(_mm512_sub_epi8(bytes, _mm512_set1_epi8(0x08)),
+                                           _mm512_set1_epi8(0x0D - 0x08))
+                };
+                const __mmask64 escape{_mm512_cmpeq_epu8_mask(bytes, _mm512_set1_epi8(0x1B))};
+                const std::uint64_t mask{printable | whitespace | escape};
+                if (mask != ~std::uint64_t{0}) {
+                    return offset + std::countr_one(mask);
+                }
+            }
+            return scalarPrefix(data, size, offset);
+        }
+#endif
+    }
+
+    std::size_t asciiTextPrefix(const std::span<const std::uint8_t> bytes) noexcept {
+        return asciiTextPrefix(bytes, detectIsa());
+    }
+
+    std::size_t asciiTextPrefix(const std::span<const std::uint8_t> bytes, const Isa isa) noexcept {
+#if FILE_SIMD_X86
+        switch (supportedIsa(isa)) {
+            case Isa::avx512:
+                return avx512Prefix(bytes.data(), bytes.size());
+            case Isa::avx2:
+                return avx2Prefix(bytes.data(), bytes.size());
+            case Isa::sse2:
+                return sse2Prefix(bytes.data(), bytes.size());
+            case Isa::scalar:
+                break;
+        }
+#endif
+        return scalarPrefix(bytes.data(), bytes.size(), 0);
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef ASCII_HPP
+#define ASCII_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "Cpu.hpp"
+
+namespace File::Simd {
+    // Length of the longest prefix of bytes made only of ASCII text (0x08-0x0D, 0x1B, 0x20-0x7E).
+    [[nodiscard]] std::size_t asciiTextPrefix(std::span<const std::uint8_t> bytes) noexcept;
+
+    [[nodiscard]] std::size_t asciiTextPrefix(std::span<const std::uint8_t> bytes, Isa isa) noexcept;
+}
+
+#endif //ASCII_HPP
@@ -0,0 +1,167 @@
+#include "ByteClass.hpp"
+#if FILE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace File::Simd {
+    namespace {
+        std::uint8_t scalarClasses(const std::uint8_t* data, const std::size_t size, std::size_t offset,
+                                   std::uint8_t candidates) noexcept {
+            constexpr std::size_t line{64};
+            while (offset < size && candidates != 0) {
+                const std::size_t end{std::min(size, offset + line)};
+                for (; offset < end; offset++) {
+                    candidates &= byteClasses[data[offset]];
+                }
+            }
+            return candidates;
+        }
+
+#if FILE_SIMD_X86
+        // byteClasses split into rectangles of high and low nibbles, so a byte's rectangles are the AND of
+        // two 16-entry lookups. Within one high nibble, the low nibbles that rule out the same candidates
+        // form a rectangle, shared with every other high nibble that has the same one.
+        struct Nibbles {
+            std::array<std::uint8_t, 16> high;
+            std::array<std::uint8_t, 16> low;
+            // The candidates ruled out by each rectangle, and by any byte of each combination of them.
+            std::array<std::uint8_t, 8> excludes;
+            std::array<std::uint8_t, 256> excluded;
+            std::size_t rectangleCount;
+        };
+
+        constexpr Nibbles buildNibbles() noexcept {
+            Nibbles nibbles{};
+            std::array<std::uint16_t, 8> lowSets{};
+            std::array<std::uint8_t, 8>& excludes{nibbles.excludes};
+            for (std::size_t high = 0; high < 16; high++) {
+                for (std::size_t first = 0; first < 16; first++) {
+                    const auto ruledOut{static_cast<std::uint8_t>(~byteClasses[high << 4 | first] & ByteClass::all)};
+                    std::uint16_t lows{0};
+                    for (std::size_t low = 0; low < 16; low++) {
+                        if ((~byteClasses[high << 4 | low] & ByteClass::all) == ruledOut) {
+                            lows |= static_cast<std::uint16_t>(1u << low);
+                        }
+                    }
+                    // Each group is handled at its first low nibble.
+                    if (ruledOut == 0 || (lows & ((1u << first) - 1)) != 0) {
+                        continue;
+                    }
+                    std::size_t rectangle{0};
+                    while (rectangle < nibbles.rectangleCount &&
+                           (lowSets[rectangle] != lows || excludes[rectangle] != ruledOut)) {
+                        rectangle++;
+                    }
+                    if (rectangle == lowSets.size()) {
+                        nibbles.rectangleCount = lowSets.size() + 1;
+                        return nibbles;
+                    }
+                    if (rectangle == nibbles.rectangleCount) {
+                        lowSets[rectangle] = lows;
+                        excludes[rectangle] = ruledOut;
+                        nibbles.rectangleCount++;
+                    }
+                    nibbles.high[high] |= static_cast<std::uint8_t>(1u << rectangle);
+                }
+            }
+            for (std::size_t rectangle = 0; rectangle < nibbles.rectangleCount; rectangle++) {
+                for (std::size_t low = 0; low < 16; low++) {
+                    if ((lowSets[rectangle] >> low & 1) != 0) {
+                        nibbles.low[low] |= static_cast<std::uint8_t>(1u << rectangle);
+                    }
+                }
+            }
+            for (std::size_t seen = 0; seen < nibbles.excluded.size(); seen++) {
+                for (std::size_t rectangle = 0; rectangle < nibbles.rectangleCount; rectangle++) {
+                    if ((seen >> rectangle & 1) != 0) {
+                        nibbles.excluded[seen] |= excludes[rectangle];
+                    }
+                }
+            }
+            return nibbles;
+        }
+
+        constexpr Nibbles nibbles{buildNibbles()};
+
+        // Sharing rectangles between high nibbles must not rule out anything byteClasses allows.
+        constexpr bool isExact() noexcept {
+            if (nibbles.rectangleCount > 8) {
+                return false;
+            }
+            for (std::size_t byte = 0; byte < byteClasses.size(); byte++) {
+                const std::uint8_t rectangles{static_cast<std::uint8_t>(nibbles.high[byte >> 4] & nibbles.low[byte & 15])};
+                if (nibbles.excluded[rectangles] != (~byteClasses[byte] & ByteClass::all)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static_assert(isExact(), "byteClasses does not fit the nibble lookup");
+
+        __attribute__((target("avx2")))
+        __m256i avx2Rectangles(const __m256i bytes, const __m256i high, const __m256i low) noexcept {
+            const __m256i lowNibble{_mm256_set1_epi8(0x0F)};
+            return _mm256_and_si256(_mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), lowNibble)),
+                                    _mm256_shuffle_epi8(low, _mm256_and_si256(bytes, lowNibble)));
+        }
+
+        __attribute__((target("avx2")))
+        std::uint8_t avx2Classes(const std::uint8_t* data, const std::size_t size, std::uint8_t candidates) noexcept {
+            const __m256i high{
+                _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(nibbles.high.data())))
+            };
+            const __m256i low{
+                _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(nibbles.low.data())))
+            };
+            // Rectangles that rule out a remaining candidate; the others can be seen without folding.
+            const auto relevantTo{
+                [](const std::uint8_t remaining) {
+                    std::uint8_t rectangles{0};
+                    for (std::size_t rectangle = 0; rectangle < nibbles.rectangleCount; rectangle++) {
+                        if ((nibbles.excludes[rectangle] & remaining) != 0) {
+                            rectangles |= static_cast<std::uint8_t>(1u << rectangle);
+                        }
+                    }
+                    return static_cast<char>(rectangles);
+                }
+            };
+            __m256i relevant{_mm256_set1_epi8(relevantTo(candidates))};
+            std::size_t offset{0};
+            __m256i seen{_mm256_setzero_si256()};
+            for (; offset + 64 <= size && candidates != 0; offset += 64) {
+                seen = _mm256_or_si256(
+                    seen, _mm256_or_si256(
+                        avx2Rectangles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset)), high, low),
+                        avx2Rectangles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + 32)), high,
+                                       low)));
+                if (_mm256_testz_si256(seen, relevant)) {
+                    continue;
+                }
+                __m128i folded{_mm_or_si128(_mm256_castsi256_si128(seen), _mm256_extracti128_si256(seen, 1))};
+                folded = _mm_or_si128(folded, _mm_srli_si128(folded, 8));
+                folded = _mm_or_si128(folded, _mm_srli_si128(folded, 4));
+                folded = _mm_or_si128(folded, _mm_srli_si128(folded, 2));
+                folded = _mm_or_si128(folded, _mm_srli_si128(folded, 1));
+                candidates &= static_cast<std::uint8_t>(~nibbles.excluded[_mm_cvtsi128_si32(folded) & 0xFF]);
+                relevant = _mm256_set1_epi8(relevantTo(candidates));
+            }
+            return scalarClasses(data, size, offset, candidates);
+        }
+#endif
+    }
+
+    std::uint8_t possibleClasses(const std::span<const std::uint8_t> bytes, const std::uint8_t candidates) noexcept {
+        return possibleClasses(bytes, candidates, detectIsa());
+    }
+
+    std::uint8_t possibleClasses(const std::span<const std::uint8_t> bytes, const std::uint8_t candidates,
+                                 const Isa isa) noexcept {
+#if FILE_SIMD_X86
+        if (supportedIsa(isa) >= Isa::avx2) {
+            return avx2Classes(bytes.data(), bytes.size(), candidates);
+        }
+#endif
+        return scalarClasses(bytes.data(), bytes.size(), 0, candidates);
+    }
+}
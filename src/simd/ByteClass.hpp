@@ -0,0 +1,55 @@
+#ifndef BYTECLASS_HPP
+#define BYTECLASS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "Cpu.hpp"
+#include "../vle/GbValidator.hpp"
+#include "../vle/Latin1.hpp"
+#include "../vle/unicode/Utf8Validator.hpp"
+
+namespace File::Simd {
+    // Candidates a byte leaves possible wherever it appears, whatever state their decoders are in. ASCII
+    // has its own prefix scan and UTF-16 admits every byte, so neither has a class.
+    namespace ByteClass {
+        constexpr std::uint8_t latin1{1 << 0};
+        constexpr std::uint8_t utf8{1 << 1};
+        constexpr std::uint8_t gb{1 << 2};
+        constexpr std::uint8_t all{latin1 | utf8 | gb};
+    }
+
+    namespace Detail {
+        // Whether some state of the DFA survives the byte.
+        template<class Validator>
+        constexpr bool canAppear(const std::uint8_t byte) noexcept {
+            return std::ranges::any_of(Validator::states, [byte](const typename Validator::State state) {
+                return state != Validator::reject && Validator::step(state, byte) != Validator::reject;
+            });
+        }
+
+        constexpr std::array<std::uint8_t, 256> buildByteClasses() noexcept {
+            std::array<std::uint8_t, 256> table{};
+            for (std::size_t i = 0; i < table.size(); i++) {
+                const auto byte{static_cast<std::uint8_t>(i)};
+                table[i] = static_cast<std::uint8_t>((Latin1::isText(byte) ? ByteClass::latin1 : 0) |
+                                                     (canAppear<Unicode::Utf8Validator>(byte) ? ByteClass::utf8 : 0) |
+                                                     (canAppear<GbValidator>(byte) ? ByteClass::gb : 0));
+            }
+            return table;
+        }
+    }
+
+    inline constexpr std::array<std::uint8_t, 256> byteClasses{Detail::buildByteClasses()};
+
+    // The subset of candidates every byte leaves possible, the AND of byteClasses over bytes. Returns as
+    // soon as no candidate is left, so binary data stops within the first cache line.
+    [[nodiscard]] std::uint8_t possibleClasses(std::span<const std::uint8_t> bytes, std::uint8_t candidates) noexcept;
+
+    [[nodiscard]] std::uint8_t possibleClasses(std::span<const std::uint8_t> bytes, std::uint8_t candidates,
+                                               Isa isa) noexcept;
+}
+
+#endif //BYTECLASS_HPP
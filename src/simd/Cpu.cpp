@@ -0,0 +1,31 @@
+#include "Cpu.hpp"
+#include <algorithm>
+
+namespace File::Simd {
+    namespace {
+        Isa queryIsa() noexcept {
+#if FILE_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512bw")) {
+                return Isa::avx512;
+            }
+            if (__builtin_cpu_supports("avx2")) {
+                return Isa::avx2;
+            }
+            if (__builtin_cpu_supports("sse2")) {
+                return Isa::sse2;
+            }
+#endif
+            return Isa::scalar;
+        }
+    }
+
+    Isa detectIsa() noexcept {
+        static const Isa isa{queryIsa()};
+        return isa;
+    }
+
+    Isa supportedIsa(const Isa requested) noexcept {
+        return std::min(requested, detectIsa());
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef CPU_HPP
+#define CPU_HPP
+
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FILE_SIMD_X86 1
+#else
+#define FILE_SIMD_X86 0
+#endif
+
+namespace File::Simd {
+    enum class Isa: std::uint8_t {
+        scalar,
+        sse2,
+        avx2,
+        avx512
+    };
+
+    // Widest instruction set both the CPU and the operating system support, detected once.
+    [[nodiscard]] Isa detectIsa() noexcept;
+
+    // Clamps a requested instruction set to what the running machine can execute.
+    [[nodiscard]] Isa supportedIsa(Isa requested) noexcept;
+}
+
+#endif //CPU_HPP
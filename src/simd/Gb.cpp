@@ -0,0 +1,95 @@
+#include "Gb.hpp"
+#include <bit>
+#if FILE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace File::Simd {
+    namespace {
+#if FILE_SIMD_X86
+        struct Masks {
+            std::uint32_t high;
+            std::uint32_t text;
+            std::uint32_t lead;
+            std::uint32_t trail;
+        };
+
+        __attribute__((target("avx2")))
+        Masks avx2Masks(const __m256i bytes) noexcept {
+            const __m256i printable{
+                _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(0x1F)),
+                                 _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7F), bytes))
+            };
+            const __m256i whitespace{
+                _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(0x07)),
+                                 _mm256_cmpgt_epi8(_mm256_set1_epi8(0x0E), bytes))
+            };
+            const __m256i escape{_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x1B))};
+            const __m256i is80{_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0x80)))};
+            const __m256i isFF{_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(static_cast<char>(0xFF)))};
+            const __m256i asciiTrail{
+                _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(0x3F)),
+                                 _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7F), bytes))
+            };
+            const auto high{static_cast<std::uint32_t>(_mm256_movemask_epi8(bytes))};
+            const auto notFF{~static_cast<std::uint32_t>(_mm256_movemask_epi8(isFF))};
+            return {
+                high,
+                static_cast<std::uint32_t>(
+                    _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(printable, whitespace), escape))),
+                high & notFF & ~static_cast<std::uint32_t>(_mm256_movemask_epi8(is80)),
+                (high & notFF) | static_cast<std::uint32_t>(_mm256_movemask_epi8(asciiTrail))
+            };
+        }
+
+        // Within each run of high bytes, the bytes at an even offset from the start of the run.
+        std::uint64_t evenInRuns(const std::uint64_t run) noexcept {
+            constexpr std::uint64_t evenBits{0x5555'5555'5555'5555};
+            const std::uint64_t starts{run & ~(run << 1)};
+            // Adding a run's start bit carries through the run and clears it.
+            const std::uint64_t oddStarted{run & ~(run + (starts & ~evenBits))};
+            return (oddStarted & ~evenBits) | (run & ~oddStarted & evenBits);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t avx2Prefix(const std::uint8_t* data, const std::size_t size) noexcept {
+            const std::size_t end{size - size % 64};
+            // Whether the byte before the current block was a lead, making the block's first byte a trail.
+            std::uint64_t pending{0};
+            for (std::size_t offset = 0; offset < end; offset += 64) {
+                const Masks first{avx2Masks(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset)))};
+                const Masks second{
+                    avx2Masks(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + 32)))
+                };
+                const std::uint64_t high{first.high | std::uint64_t{second.high} << 32};
+                const std::uint64_t text{first.text | std::uint64_t{second.text} << 32};
+                const std::uint64_t lead{first.lead | std::uint64_t{second.lead} << 32};
+                const std::uint64_t trail{first.trail | std::uint64_t{second.trail} << 32};
+                // Outside four-byte sequences every high byte on a boundary is a lead and the byte after
+                // it its trail, so leads alternate with trails through each run of high bytes.
+                const std::uint64_t leads{evenInRuns(high & ~pending)};
+                const std::uint64_t trails{leads << 1 | pending};
+                const std::uint64_t errors{
+                    (leads & ~lead) | (trails & ~trail) | (~(leads | trails) & ~text)
+                };
+                if (errors != 0) {
+                    // Back up to the lead of a failing trail so the DFA sees the whole sequence.
+                    const auto position{static_cast<std::size_t>(std::countr_zero(errors))};
+                    return offset + position - ((trails >> position & 1) != 0 ? 1 : 0);
+                }
+                pending = leads >> 63;
+            }
+            return end - pending;
+        }
+#endif
+    }
+
+    std::size_t gbTwoBytePrefix(const std::span<const std::uint8_t> bytes, const Isa isa) noexcept {
+#if FILE_SIMD_X86
+        if (supportedIsa(isa) >= Isa::avx2) {
+            return avx2Prefix(bytes.data(), bytes.size());
+        }
+#endif
+        return 0;
+    }
+}
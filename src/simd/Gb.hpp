@@ -0,0 +1,16 @@
+#ifndef SIMD_GB_HPP
+#define SIMD_GB_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "Cpu.hpp"
+
+namespace File::Simd {
+    // Length of the longest prefix of bytes, which must start on a sequence boundary, made of ASCII text
+    // and two-byte GB 18030 sequences, checked 64 bytes at a time. The prefix always ends on a sequence
+    // boundary; four-byte sequences, errors and the tail are left to GbValidator's DFA.
+    [[nodiscard]] std::size_t gbTwoBytePrefix(std::span<const std::uint8_t> bytes, Isa isa) noexcept;
+}
+
+#endif //SIMD_GB_HPP
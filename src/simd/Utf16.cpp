@@ -0,0 +1,92 @@
+#include "Utf16.hpp"
+#if FILE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace File::Simd {
+    namespace {
+#if FILE_SIMD_X86
+        struct Masks {
+            std::uint32_t high;
+            std::uint32_t low;
+            std::uint32_t controls;
+        };
+
+        // Two mask bits per code unit, as _mm256_movemask_epi8 leaves them.
+        __attribute__((target("avx2")))
+        Masks avx2Masks(const __m256i units) noexcept {
+            const __m256i surrogateBits{_mm256_and_si256(units, _mm256_set1_epi16(static_cast<short>(0xFC00)))};
+            const __m256i high{_mm256_cmpeq_epi16(surrogateBits, _mm256_set1_epi16(static_cast<short>(0xD800)))};
+            const __m256i low{_mm256_cmpeq_epi16(surrogateBits, _mm256_set1_epi16(static_cast<short>(0xDC00)))};
+            // Unicode::isText only rejects code points below U+00A0; those are positive as signed lanes.
+            const __m256i small{
+                _mm256_cmpeq_epi16(_mm256_min_epu16(units, _mm256_set1_epi16(0x9F)), units)
+            };
+            const __m256i text{
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi16(units, _mm256_set1_epi16(0x1F)),
+                                                     _mm256_cmpgt_epi16(_mm256_set1_epi16(0x7F), units)),
+                                    _mm256_and_si256(_mm256_cmpgt_epi16(units, _mm256_set1_epi16(0x07)),
+                                                     _mm256_cmpgt_epi16(_mm256_set1_epi16(0x0E), units))),
+                    _mm256_cmpeq_epi16(units, _mm256_set1_epi16(0x1B)))
+            };
+            return {
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(high)),
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(low)),
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(text, small)))
+            };
+        }
+
+        __attribute__((target("avx2")))
+        std::optional<std::size_t> avx2ValidPrefix(const std::uint8_t* data, const std::size_t size,
+                                                   const bool isBigEndian) noexcept {
+            constexpr std::size_t checkInterval{4096};
+            const std::size_t end{size - size % 64};
+            if (end == 0) {
+                return 0;
+            }
+            // Big-endian units are swapped into lane order in register.
+            const __m256i swap{
+                _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+            };
+            std::uint64_t errors{0};
+            std::uint64_t carry{0};
+            for (std::size_t offset = 0; offset < end; offset += 64) {
+                __m256i first{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset))};
+                __m256i second{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + 32))};
+                if (isBigEndian) {
+                    first = _mm256_shuffle_epi8(first, swap);
+                    second = _mm256_shuffle_epi8(second, swap);
+                }
+                const Masks firstMasks{avx2Masks(first)};
+                const Masks secondMasks{avx2Masks(second)};
+                const std::uint64_t high{firstMasks.high | std::uint64_t{secondMasks.high} << 32};
+                const std::uint64_t low{firstMasks.low | std::uint64_t{secondMasks.low} << 32};
+                // Every low surrogate follows a high one and every high one is followed by a low one.
+                errors |= low ^ (high << 2 | carry);
+                errors |= firstMasks.controls | std::uint64_t{secondMasks.controls} << 32;
+                carry = high >> 62;
+                if ((offset + 64) % checkInterval == 0 && errors != 0) {
+                    return std::nullopt;
+                }
+            }
+            if (errors != 0) {
+                return std::nullopt;
+            }
+            // A high surrogate at the very end still waits for its partner; hand it back.
+            return carry != 0 ? end - 2 : end;
+        }
+#endif
+    }
+
+    std::optional<std::size_t> utf16ValidPrefix(const std::span<const std::uint8_t> bytes,
+                                                 const Unicode::Endianness endianness, const Isa isa) noexcept {
+#if FILE_SIMD_X86
+        if (supportedIsa(isa) >= Isa::avx2) {
+            return avx2ValidPrefix(bytes.data(), bytes.size(), endianness == Unicode::Endianness::bigEndian);
+        }
+#endif
+        return 0;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef SIMD_UTF16_HPP
+#define SIMD_UTF16_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include "Cpu.hpp"
+#include "../vle/Unicode.hpp"
+
+namespace File::Simd {
+    // Validates UTF-16 code units after the byte order mark, 64 bytes at a time with the rules of
+    // Unicode::Utf16Validator. bytes must start on a code unit with no surrogate pending. Returns the
+    // length of the checked prefix, which never ends inside a surrogate pair so the caller can resume
+    // there with the scalar DFA, or std::nullopt if the units are invalid.
+    [[nodiscard]] std::optional<std::size_t> utf16ValidPrefix(std::span<const std::uint8_t> bytes,
+                                                              Unicode::Endianness endianness, Isa isa) noexcept;
+}
+
+#endif //SIMD_UTF16_HPP
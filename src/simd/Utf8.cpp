@@ -0,0 +1,153 @@
+#include "Utf8.hpp"
+#if FILE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace File::Simd {
+    namespace {
+#if FILE_SIMD_X86
+        // Error classes of the three-nibble lookup (Keiser and Lemire), indexed by the high and low
+        // nibbles of the previous byte and the high nibble of the current one. The surrogate class is
+        // left out on purpose: Utf8Sequence accepts encoded surrogates.
+        constexpr std::uint8_t tooShort{1 << 0};
+        constexpr std::uint8_t tooLong{1 << 1};
+        constexpr std::uint8_t overlong3{1 << 2};
+        constexpr std::uint8_t tooLarge{1 << 3};
+        constexpr std::uint8_t overlong2{1 << 5};
+        constexpr std::uint8_t tooLarge1000{1 << 6};
+        constexpr std::uint8_t overlong4{1 << 6};
+        constexpr std::uint8_t twoContinuations{1 << 7};
+        constexpr std::uint8_t carry{tooShort | tooLong | twoContinuations};
+
+        __attribute__((target("avx2")))
+        __m256i lookup(const __m256i indices, const std::uint8_t (&table)[16]) noexcept {
+            const __m128i row{_mm_loadu_si128(reinterpret_cast<const __m128i*>(table))};
+            return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(row), indices);
+        }
+
+        __attribute__((target("avx2")))
+        __m256i highNibbles(const __m256i bytes) noexcept {
+            return _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+        }
+
+        template<int N>
+        __attribute__((target("avx2")))
+        __m256i previous(const __m256i input, const __m256i previousInput) noexcept {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previousInput, input, 0x21), 16 - N);
+        }
+
+        __attribute__((target("avx2")))
+        __m256i avx2Errors(const __m256i input, const __m256i previousInput) noexcept {
+            static constexpr std::uint8_t byte1High[16]{
+                tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong,
+                twoContinuations, twoContinuations, twoContinuations, twoContinuations,
+                tooShort | overlong2,
+                tooShort,
+                tooShort | overlong3,
+                tooShort | tooLarge | tooLarge1000 | overlong4
+            };
+            static constexpr std::uint8_t byte1Low[16]{
+                carry | overlong3 | overlong2 | overlong4,
+                carry | overlong2,
+                carry,
+                carry,
+                carry | tooLarge,
+                carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+                carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+                carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+                carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+                carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+                carry | tooLarge | tooLarge1000
+            };
+            static constexpr std::uint8_t byte2High[16]{
+                tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort,
+                tooLong | overlong2 | twoContinuations | overlong3 | tooLarge1000 | overlong4,
+                tooLong | overlong2 | twoContinuations | overlong3 | tooLarge,
+                tooLong | overlong2 | twoContinuations | tooLarge,
+                tooLong | overlong2 | twoContinuations | tooLarge,
+                tooShort, tooShort, tooShort, tooShort
+            };
+            const __m256i previous1{previous<1>(input, previousInput)};
+            const __m256i specialCases{
+                _mm256_and_si256(_mm256_and_si256(lookup(highNibbles(previous1), byte1High),
+                                                  lookup(_mm256_and_si256(previous1, _mm256_set1_epi8(0x0F)),
+                                                         byte1Low)),
+                                 lookup(highNibbles(input), byte2High))
+            };
+            // Third and fourth bytes of a sequence are the only places two continuations may meet.
+            const __m256i isThirdByte{
+                _mm256_subs_epu8(previous<2>(input, previousInput), _mm256_set1_epi8(0xE0 - 0x80))
+            };
+            const __m256i isFourthByte{
+                _mm256_subs_epu8(previous<3>(input, previousInput), _mm256_set1_epi8(0xF0 - 0x80))
+            };
+            const __m256i mustBeContinuation{
+                _mm256_and_si256(_mm256_or_si256(isThirdByte, isFourthByte), _mm256_set1_epi8(0x80))
+            };
+            const __m256i lengthErrors{_mm256_xor_si256(mustBeContinuation, specialCases)};
+            // Unicode::isText rejects C0 controls and DEL as single bytes, and C1 controls as C2 80-9F.
+            const __m256i text{
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8(0x1F)),
+                                                     _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7F), input)),
+                                    _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8(0x07)),
+                                                     _mm256_cmpgt_epi8(_mm256_set1_epi8(0x0E), input))),
+                    _mm256_cmpeq_epi8(input, _mm256_set1_epi8(0x1B)))
+            };
+            const __m256i controls{
+                _mm256_andnot_si256(text, _mm256_cmpgt_epi8(input, _mm256_set1_epi8(-1)))
+            };
+            const __m256i c1Controls{
+                _mm256_and_si256(_mm256_cmpeq_epi8(previous1, _mm256_set1_epi8(static_cast<char>(0xC2))),
+                                 _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0xA0)), input))
+            };
+            return _mm256_or_si256(lengthErrors, _mm256_or_si256(controls, c1Controls));
+        }
+
+        __attribute__((target("avx2")))
+        std::optional<std::size_t> avx2ValidPrefix(const std::uint8_t* data, const std::size_t size) noexcept {
+            constexpr std::size_t checkInterval{4096};
+            const std::size_t end{size - size % 64};
+            if (end == 0) {
+                return 0;
+            }
+            __m256i previousInput{_mm256_setzero_si256()};
+            __m256i errors{_mm256_setzero_si256()};
+            for (std::size_t offset = 0; offset < end; offset += 64) {
+                const __m256i low{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset))};
+                const __m256i high{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + 32))};
+                errors = _mm256_or_si256(errors, avx2Errors(low, previousInput));
+                errors = _mm256_or_si256(errors, avx2Errors(high, low));
+                previousInput = high;
+                if ((offset + 64) % checkInterval == 0 && !_mm256_testz_si256(errors, errors)) {
+                    return std::nullopt;
+                }
+            }
+            if (!_mm256_testz_si256(errors, errors)) {
+                return std::nullopt;
+            }
+            // A sequence may still be open across the end; hand back from its lead byte.
+            for (std::size_t offset = end - 1; offset >= end - 3; offset--) {
+                if (data[offset] >= 0xC0) {
+                    return offset;
+                }
+            }
+            return end;
+        }
+#endif
+    }
+
+    std::optional<std::size_t> utf8ValidPrefix(const std::span<const std::uint8_t> bytes) noexcept {
+        return utf8ValidPrefix(bytes, detectIsa());
+    }
+
+    std::optional<std::size_t> utf8ValidPrefix(const std::span<const std::uint8_t> bytes,
+                                                const Isa isa) noexcept {
+#if FILE_SIMD_X86
+        if (supportedIsa(isa) >= Isa::avx2) {
+            return avx2ValidPrefix(bytes.data(), bytes.size());
+        }
+#endif
+        return 0;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef SIMD_UTF8_HPP
+#define SIMD_UTF8_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include "Cpu.hpp"
+
+namespace File::Simd {
+    // Validates bytes, which must start on a sequence boundary, 64 bytes at a time with the rules of
+    // Unicode::Utf8Validator. Returns the length of the checked prefix, which always ends on a sequence
+    // boundary so the caller can resume there with the scalar DFA, or std::nullopt if the bytes are invalid.
+    [[nodiscard]] std::optional<std::size_t> utf8ValidPrefix(std::span<const std::uint8_t> bytes) noexcept;
+
+    [[nodiscard]] std::optional<std::size_t> utf8ValidPrefix(std::span<const std::uint8_t> bytes,
+                                                             Isa isa) noexcept;
+}
+
+#endif //SIMD_UTF8_HPP
@@ -3,18 +3,103 @@
 
 #include <concepts>
 #include <optional>
+#include <span>
+#include <type_traits>
 
 namespace File {
+    // A variable-length encoding defined one sequence at a time. Classification runs on the BlockVle
+    // validators below; the Vle types are the definitions the fuzz target checks them against.
     template<class Encoding, typename Point>
-    concept Vle = requires(Encoding e, Point p)
+    concept Vle = requires(Encoding e, Point p, std::optional<Encoding> pending,
+                           std::span<const typename Encoding::Point> block)
     {
         typename Encoding::Point;
         requires std::convertible_to<typename Encoding::Point, Point>;
+        requires std::is_trivially_copyable_v<Encoding>;
         { Encoding::build(p) } -> std::convertible_to<std::optional<Encoding> >;
         { e.isComplete() } -> std::convertible_to<bool>;
         { e.addPoint(p) } -> std::convertible_to<bool>;
         { e.isValid() } -> std::convertible_to<bool>;
+        { Encoding::consume(pending, block) } -> std::convertible_to<bool>;
     };
+
+    template<class Validator, typename Point>
+    concept BlockVle = requires(Validator v, std::span<const Point> block)
+    {
+        typename Validator::Point;
+        requires std::convertible_to<typename Validator::Point, Point>;
+        { v.consume(block) } -> std::convertible_to<bool>;
+        { v.isComplete() } -> std::convertible_to<bool>;
+        { v.isValid() } -> std::convertible_to<bool>;
+        { v.reset() };
+    };
+
+    // The block form of validateVle, shared by the consume of each sequence type. The open sequence lives in
+    // a local across the loop rather than in the optional, which keeps the fuzz target and the sequence
+    // benchmarks quick; no classification path calls it.
+    template<class T>
+    bool consumeSequences(std::optional<T>& pending, const std::span<const typename T::Point> block) noexcept {
+        std::optional<T> open{pending};
+        pending.reset();
+        for (const typename T::Point point: block) {
+            if (open.has_value()) {
+                if (!open->addPoint(point)) {
+                    return false;
+                }
+                if (open->isComplete()) {
+                    if (!open->isValid()) {
+                        return false;
+                    }
+                    open.reset();
+                }
+                continue;
+            }
+            const std::optional<T> built{T::build(point)};
+            if (!built.has_value()) {
+                return false;
+            }
+            if (!built->isComplete()) {
+                open = built;
+            } else if (!built->isValid()) {
+                return false;
+            }
+        }
+        pending = open;
+        return true;
+    }
+
+    template<typename Point, Vle<Point> T>
+    void validateVle(bool& isValid, std::optional<T>& vleSequence, typename T::Point point) {
+        if (vleSequence.has_value()) {
+            T& sequence{vleSequence.value()};
+            if (!sequence.isComplete() && !sequence.addPoint(point)) {
+                isValid = false;
+                return;
+            }
+            if (sequence.isComplete()) {
+                if (!sequence.isValid()) {
+                    isValid = false;
+                }
+                vleSequence.reset();
+                return;
+            }
+            return;
+        }
+        std::optional<T> possibleSequence{T::build(point)};
+        if (possibleSequence.has_value()) {
+            T sequence{possibleSequence.value()};
+            if (!sequence.isComplete()) {
+                vleSequence.emplace(sequence);
+                return;
+            }
+            if (!sequence.isValid()) {
+                isValid = false;
+                return;
+            }
+            return;
+        }
+        isValid = false;
+    }
 }
 
 #endif //VLE_HPP
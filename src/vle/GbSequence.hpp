@@ -1,29 +1,82 @@
 #ifndef GBSEQUENCE_HPP
 #define GBSEQUENCE_HPP
 
-#include <array>
 #include <cstdint>
 #include <optional>
+#include <span>
+#include "Latin1.hpp"
 
 namespace File {
+    // One GB 18030 sequence packed into a single word: the lead byte, how many bytes have arrived and
+    // whether the sequence is complete. Later bytes are only checked against their own range, so they
+    // need not be kept. This is the reference for GbValidator, which classification runs on instead.
     class GbSequence {
-        std::array<std::uint8_t, 4> m_data;
-        std::uint8_t m_currentLength : 3;
-        bool m_isComplete : 1;
+        static constexpr unsigned lengthShift{8};
+        static constexpr std::uint32_t completeBit{1u << 16};
 
-        GbSequence(std::array<std::uint8_t, 4>&& data, bool isComplete) noexcept;
+        std::uint32_t m_state{};
+
+        explicit constexpr GbSequence(const std::uint32_t state) noexcept : m_state{state} { }
+
+        [[nodiscard]] constexpr std::uint8_t lead() const noexcept {
+            return static_cast<std::uint8_t>(m_state);
+        }
+
+        [[nodiscard]] constexpr std::uint32_t length() const noexcept {
+            return m_state >> lengthShift & 0xFF;
+        }
 
     public:
         using Point = std::uint8_t;
 
-        static std::optional<GbSequence> build(Point byte) noexcept;
+        [[nodiscard]] static constexpr std::optional<GbSequence> build(const Point byte) noexcept {
+            if (byte == 0x80 || byte == 0xFF) {
+                return std::nullopt;
+            }
+            return GbSequence{(byte <= 0x7F ? completeBit : 0) | 1u << lengthShift | byte};
+        }
 
-        [[nodiscard]] bool isComplete() const;
+        [[nodiscard]] constexpr bool isComplete() const noexcept {
+            return (m_state & completeBit) != 0;
+        }
 
-        bool addPoint(Point point);
+        constexpr bool addPoint(Point point) noexcept;
 
-        [[nodiscard]] bool isValid() const;
+        [[nodiscard]] constexpr bool isValid() const noexcept {
+            if (isComplete() && length() == 1) {
+                return Latin1::isAsciiText(lead());
+            }
+            return isComplete();
+        }
+
+        // Runs validateVle over a block, carrying a sequence left open at its end in pending.
+        static bool consume(std::optional<GbSequence>& pending, std::span<const Point> block) noexcept;
     };
+
+    constexpr bool GbSequence::addPoint(const Point point) noexcept {
+        const std::uint32_t added{length() + 1};
+        if (added > 4) {
+            return false;
+        }
+        m_state = (m_state & ~(0xFFu << lengthShift)) | added << lengthShift;
+        switch (added) {
+            case 2:
+                if (0x81 <= lead() && lead() <= 0xFE) {
+                    if ((0x40 <= point && point <= 0xFE) && point != 0x7F) {
+                        m_state |= completeBit;
+                        return true;
+                    }
+                    return ((0x81 <= lead() && lead() <= 0x84) || (0x90 <= lead() && lead() <= 0xE3)) &&
+                           (0x30 <= point && point <= 0x39);
+                }
+                return false;
+            case 3:
+                return 0x81 <= point && point <= 0xFE;
+            default:
+                m_state |= completeBit;
+                return 0x30 <= point && point <= 0x39;
+        }
+    }
 } // File
 
 #endif //GBSEQUENCE_HPP
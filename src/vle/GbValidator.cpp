@@ -0,0 +1,24 @@
+#include "GbValidator.hpp"
+#include <algorithm>
+#include "../simd/Gb.hpp"
+
+namespace File {
+    GbValidator::GbValidator() noexcept : GbValidator{Simd::detectIsa()} { }
+
+    bool GbValidator::consume(std::span<const Point> block) noexcept {
+        // The vector kernel stops at four-byte sequences, so the DFA only runs for a short stretch before
+        // the kernel is tried again. Without a kernel the stretches are long.
+        const std::size_t stride{Simd::supportedIsa(m_isa) >= Simd::Isa::avx2 ? 64u : 4096u};
+        State state{m_state};
+        while (!block.empty() && state != reject) {
+            if (state == start) {
+                block = block.subspan(Simd::gbTwoBytePrefix(block, m_isa));
+            }
+            const std::size_t length{std::min(block.size(), stride)};
+            state = run(state, block.first(length));
+            block = block.subspan(length);
+        }
+        m_state = state;
+        return m_state != reject;
+    }
+} // File
@@ -0,0 +1,67 @@
+#ifndef GBVALIDATOR_HPP
+#define GBVALIDATOR_HPP
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include "Latin1.hpp"
+#include "ShiftDfa.hpp"
+#include "../simd/Cpu.hpp"
+
+namespace File {
+    // The GB 18030 states for ShiftDfa, accepting exactly the byte streams GbSequence accepts.
+    struct GbTransitions {
+        static constexpr std::uint64_t start{0};
+        static constexpr std::uint64_t reject{6};
+        // After a lead that can open either a two- or a four-byte sequence.
+        static constexpr std::uint64_t afterLead{12};
+        // After a lead that can only open a two-byte sequence.
+        static constexpr std::uint64_t afterTwoByteLead{18};
+        static constexpr std::uint64_t needThird{24};
+        static constexpr std::uint64_t needFourth{30};
+        static constexpr std::array<std::uint64_t, 6> states{
+            start, reject, afterLead, afterTwoByteLead, needThird, needFourth
+        };
+
+        static constexpr std::uint64_t next(std::uint64_t state, std::uint8_t byte) noexcept;
+    };
+
+    class GbValidator : public ShiftDfa<GbTransitions> {
+    public:
+        GbValidator() noexcept;
+
+        explicit constexpr GbValidator(const Simd::Isa isa) noexcept : ShiftDfa{isa} { }
+
+        bool consume(std::span<const Point> block) noexcept;
+    };
+
+    constexpr std::uint64_t GbTransitions::next(const std::uint64_t state, const std::uint8_t byte) noexcept {
+        const bool isTrail{0x40 <= byte && byte <= 0xFE && byte != 0x7F};
+        const bool isDigit{0x30 <= byte && byte <= 0x39};
+        switch (state) {
+            case start:
+                if (byte <= 0x7F) {
+                    return Latin1::isAsciiText(byte) ? start : reject;
+                }
+                if ((0x81 <= byte && byte <= 0x84) || (0x90 <= byte && byte <= 0xE3)) {
+                    return afterLead;
+                }
+                return byte == 0x80 || byte == 0xFF ? reject : afterTwoByteLead;
+            case afterLead:
+                if (isDigit) {
+                    return needThird;
+                }
+                return isTrail ? start : reject;
+            case afterTwoByteLead:
+                return isTrail ? start : reject;
+            case needThird:
+                return 0x81 <= byte && byte <= 0xFE ? needFourth : reject;
+            case needFourth:
+                return isDigit ? start : reject;
+            default:
+                return reject;
+        }
+    }
+} // File
+
+#endif //GBVALIDATOR_HPP
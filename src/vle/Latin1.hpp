@@ -0,0 +1,16 @@
+#ifndef LATIN1_HPP
+#define LATIN1_HPP
+
+#include <cstdint>
+
+namespace File::Latin1 {
+    [[nodiscard]] constexpr bool isAsciiText(const std::uint8_t byte) {
+        return (0x08 <= byte && byte <= 0x0D) || byte == 0x1B || (0x20 <= byte && byte <= 0x7E);
+    }
+
+    [[nodiscard]] constexpr bool isText(const std::uint8_t byte) {
+        return isAsciiText(byte) || byte >= 0xA0;
+    }
+}
+
+#endif //LATIN1_HPP
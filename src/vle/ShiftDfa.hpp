@@ -0,0 +1,90 @@
+#ifndef SHIFTDFA_HPP
+#define SHIFTDFA_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "../simd/Cpu.hpp"
+
+namespace File {
+    // A byte DFA packed into one 64-bit row per byte: states are bit offsets six bits apart, and the row of a
+    // byte holds at each state's offset the state it leads to, so a step is a load and a shift. Table names
+    // the states, with 0 as the start and only accepting state, and gives next(state, byte); the validators
+    // built on it add only their consume.
+    template<class Table>
+    class ShiftDfa : public Table {
+    public:
+        using Point = std::uint8_t;
+        using State = std::uint64_t;
+
+        static constexpr State initial{0};
+
+        static_assert(Table::states[0] == initial && Table::states.size() * 6 <= 64);
+
+    private:
+        static constexpr std::array<std::uint64_t, 256> buildTransitions() noexcept;
+
+    protected:
+        State m_state;
+        Simd::Isa m_isa;
+
+        explicit constexpr ShiftDfa(const Simd::Isa isa) noexcept : m_state{initial}, m_isa{isa} { }
+
+        // Runs every byte through the DFA. Rejection is sticky and the offset is only masked at the end, so
+        // the loop has no branches; callers check for rejection between runs.
+        [[nodiscard]] static State run(State state, const std::span<const Point> bytes) noexcept {
+            for (const Point byte: bytes) {
+                state = transitions[byte] >> (state & 63);
+            }
+            return state & 63;
+        }
+
+    public:
+        static const std::array<std::uint64_t, 256> transitions;
+
+        [[nodiscard]] static constexpr State step(const State state, const Point byte) noexcept {
+            return transitions[byte] >> (state & 63) & 63;
+        }
+
+        [[nodiscard]] static constexpr bool isAccepting(const State state) noexcept {
+            return state == initial;
+        }
+
+        [[nodiscard]] bool isComplete() const noexcept {
+            return m_state == initial || m_state == Table::reject;
+        }
+
+        [[nodiscard]] bool isValid() const noexcept {
+            return m_state == initial;
+        }
+
+        [[nodiscard]] State state() const noexcept {
+            return m_state;
+        }
+
+        void resume(const State state) noexcept {
+            m_state = state;
+        }
+
+        void reset() noexcept {
+            m_state = initial;
+        }
+    };
+
+    template<class Table>
+    constexpr std::array<std::uint64_t, 256> ShiftDfa<Table>::buildTransitions() noexcept {
+        std::array<std::uint64_t, 256> rows{};
+        for (std::size_t byte = 0; byte < rows.size(); byte++) {
+            for (const State state: Table::states) {
+                rows[byte] |= Table::next(state, static_cast<Point>(byte)) << state;
+            }
+        }
+        return rows;
+    }
+
+    template<class Table>
+    inline constexpr std::array<std::uint64_t, 256> ShiftDfa<Table>::transitions{buildTransitions()};
+} // File
+
+#endif //SHIFTDFA_HPP
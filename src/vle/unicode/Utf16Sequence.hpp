@@ -1,36 +1,57 @@
 #ifndef UTF16SEQUENCE_HPP
 #define UTF16SEQUENCE_HPP
 
-#include <array>
 #include <cstdint>
 #include <optional>
-#include <variant>
+#include <span>
+#include "../Unicode.hpp"
 
 namespace File::Unicode {
+    // One UTF-16 sequence packed into a single word: a lone code unit, a high surrogate waiting for its
+    // partner with the pending bit set, or the code point of a completed pair. Utf16Validator does the
+    // classifying; the fuzz target holds it to this.
     class Utf16Sequence {
-        struct Surrogate {
-            std::array<uint16_t, 2> data;
-            bool isComplete;
-        };
-        using Bmp = std::uint16_t;
-        using Utf16Type = std::variant<Bmp, Surrogate>;
+        static constexpr std::uint32_t pendingBit{1u << 31};
 
-        Utf16Type m_data;
+        std::uint32_t m_state{};
 
-        explicit Utf16Sequence(Utf16Type data);
+        explicit constexpr Utf16Sequence(const std::uint32_t state) noexcept : m_state{state} { }
 
-        [[nodiscard]] std::uint32_t getCodepoint() const;
+        [[nodiscard]] static constexpr bool isHighSurrogate(const std::uint32_t unit) noexcept {
+            return 0xD800 <= unit && unit <= 0xDBFF;
+        }
+
+        [[nodiscard]] static constexpr bool isLowSurrogate(const std::uint32_t unit) noexcept {
+            return 0xDC00 <= unit && unit <= 0xDFFF;
+        }
 
     public:
         using Point = std::uint16_t;
 
-        [[nodiscard]] static std::optional<Utf16Sequence> build(Point point);
-
-        [[nodiscard]] bool isComplete() const;
-
-        bool addPoint(Point point);
-
-        [[nodiscard]] bool isValid() const;
+        [[nodiscard]] static constexpr std::optional<Utf16Sequence> build(const Point point) noexcept {
+            return Utf16Sequence{isHighSurrogate(point) ? pendingBit | point : point};
+        }
+
+        [[nodiscard]] constexpr bool isComplete() const noexcept {
+            return (m_state & pendingBit) == 0;
+        }
+
+        constexpr bool addPoint(const Point point) noexcept {
+            if (isComplete() || !isLowSurrogate(point)) {
+                return false;
+            }
+            m_state = ((m_state & ~pendingBit) - 0xD800) * 0x400 + (point - 0xDC00u) + 0x1'0000;
+            return true;
+        }
+
+        // Pairs always decode past U+FFFF, so only a lone code unit can land in the surrogate range.
+        [[nodiscard]] constexpr bool isValid() const noexcept {
+            return isComplete() && !(0xD800 <= m_state && m_state <= 0xDFFF) && m_state <= 0x10'FFFF &&
+                   isText(m_state);
+        }
+
+        // Runs validateVle over a block, carrying a sequence left open at its end in pending.
+        static bool consume(std::optional<Utf16Sequence>& pending, std::span<const Point> block) noexcept;
     };
 }
 
@@ -0,0 +1,71 @@
+#include "Utf16Validator.hpp"
+#include <algorithm>
+#include "../../simd/Utf16.hpp"
+
+namespace File::Unicode {
+    Utf16Validator::Utf16Validator() noexcept : Utf16Validator{Simd::detectIsa()} { }
+
+    bool Utf16Validator::consume(std::span<const Point> block) noexcept {
+        constexpr std::size_t stride{4096};
+        State state{m_state};
+        // Step to the first code unit boundary with no surrogate pending, where the vector kernel can start.
+        while (!block.empty() && state != reject && state != bigStart && state != littleStart) {
+            state = step(state, block.front());
+            block = block.subspan(1);
+        }
+        if (state == bigStart || state == littleStart) {
+            const Endianness endianness{state == bigStart ? Endianness::bigEndian : Endianness::littleEndian};
+            const std::optional<std::size_t> checked{Simd::utf16ValidPrefix(block, endianness, m_isa)};
+            if (!checked.has_value()) {
+                m_state = reject;
+                return false;
+            }
+            block = block.subspan(*checked);
+        }
+        while (!block.empty() && state != reject) {
+            const std::size_t length{std::min(block.size(), stride)};
+            for (const Point byte: block.first(length)) {
+                state = step(state, byte);
+            }
+            block = block.subspan(length);
+        }
+        m_state = state;
+        return m_state != reject;
+    }
+
+    void Utf16Validator::skipAsciiText(const std::uint64_t count) noexcept {
+        if ((m_state == asciiEven || m_state == asciiOdd) && count % 2 == 1) {
+            m_state = m_state == asciiEven ? asciiOdd : asciiEven;
+        }
+    }
+
+    bool Utf16Validator::isComplete() const noexcept {
+        return isAccepting(m_state) || m_state == reject;
+    }
+
+    bool Utf16Validator::isValid() const noexcept {
+        return isAccepting(m_state);
+    }
+
+    std::optional<Endianness> Utf16Validator::endianness() const noexcept {
+        if (bigStart <= m_state && m_state <= bigPendingAfterLow) {
+            return Endianness::bigEndian;
+        }
+        if (littleStart <= m_state && m_state <= littlePendingAfterLow) {
+            return Endianness::littleEndian;
+        }
+        return std::nullopt;
+    }
+
+    Utf16Validator::State Utf16Validator::state() const noexcept {
+        return m_state;
+    }
+
+    void Utf16Validator::resume(const State state) noexcept {
+        m_state = state;
+    }
+
+    void Utf16Validator::reset() noexcept {
+        m_state = asciiEven;
+    }
+}
@@ -0,0 +1,171 @@
+#ifndef UTF16VALIDATOR_HPP
+#define UTF16VALIDATOR_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include "../../simd/Cpu.hpp"
+#include "../Unicode.hpp"
+
+namespace File::Unicode {
+    // Byte-level DFA reproducing the UTF-16 detection of the classifier: decoding starts at the first
+    // byte outside the ASCII text set, which has to sit at an even offset and open a byte order mark,
+    // and the code units that follow must form the sequences Utf16Sequence accepts. A trailing odd byte
+    // is never decoded.
+    class Utf16Validator {
+    public:
+        using Point = std::uint8_t;
+        using State = std::uint8_t;
+
+        enum : State {
+            asciiEven,
+            asciiOdd,
+            reject,
+            afterFE,
+            afterFF,
+            afterOther,
+            // Big endian: the high byte of each unit arrives first.
+            bigStart,
+            bigAfterZero,
+            bigAfterLow,
+            bigAfterOther,
+            bigAfterHigh,
+            bigPending,
+            bigPendingAfterLow,
+            // Little endian: the low byte arrives first, so it is classified before the high byte.
+            littleStart,
+            littleAfterText,
+            littleAfterControl,
+            littlePending,
+            littlePendingAfterLow,
+            stateCount
+        };
+
+        static constexpr std::array<State, stateCount> states{
+            asciiEven, asciiOdd, reject, afterFE, afterFF, afterOther,
+            bigStart, bigAfterZero, bigAfterLow, bigAfterOther, bigAfterHigh, bigPending, bigPendingAfterLow,
+            littleStart, littleAfterText, littleAfterControl, littlePending, littlePendingAfterLow
+        };
+
+        // States that can be entered at an even byte offset, where every code unit starts.
+        static constexpr std::array<State, 6> evenStates{
+            asciiEven, reject, bigStart, bigPending, littleStart, littlePending
+        };
+
+    private:
+        State m_state;
+        Simd::Isa m_isa;
+
+        static constexpr State next(State state, Point byte) noexcept;
+
+        static constexpr std::array<State, stateCount * 256> buildTransitions() noexcept;
+
+    public:
+        static const std::array<State, stateCount * 256> transitions;
+
+        Utf16Validator() noexcept;
+
+        explicit constexpr Utf16Validator(const Simd::Isa isa) noexcept : m_state{asciiEven}, m_isa{isa} { }
+
+        [[nodiscard]] static constexpr State step(const State state, const Point byte) noexcept {
+            return transitions[state << 8 | byte];
+        }
+
+        [[nodiscard]] static constexpr bool isAccepting(const State state) noexcept {
+            return state != reject && state != bigPending && state != bigPendingAfterLow &&
+                   state != littlePending && state != littlePendingAfterLow;
+        }
+
+        bool consume(std::span<const Point> block) noexcept;
+
+        // Advances over count bytes known to be ASCII text without looking at them.
+        void skipAsciiText(std::uint64_t count) noexcept;
+
+        [[nodiscard]] bool isComplete() const noexcept;
+
+        [[nodiscard]] bool isValid() const noexcept;
+
+        [[nodiscard]] std::optional<Endianness> endianness() const noexcept;
+
+        [[nodiscard]] State state() const noexcept;
+
+        void resume(State state) noexcept;
+
+        void reset() noexcept;
+    };
+
+    constexpr Utf16Validator::State Utf16Validator::next(const State state, const Point byte) noexcept {
+        const bool isHighSurrogate{0xD8 <= byte && byte <= 0xDB};
+        const bool isLowSurrogate{0xDC <= byte && byte <= 0xDF};
+        switch (state) {
+            case asciiEven:
+                if (byte < 0x80 && isText(byte)) {
+                    return asciiOdd;
+                }
+                if (byte == 0xFE) {
+                    return afterFE;
+                }
+                return byte == 0xFF ? afterFF : afterOther;
+            case asciiOdd:
+                // The first decoded pair would start with a byte that was never read, so no BOM is possible.
+                return byte < 0x80 && isText(byte) ? asciiEven : reject;
+            case afterFE:
+                return byte == 0xFF ? bigStart : reject;
+            case afterFF:
+                return byte == 0xFE ? littleStart : reject;
+            case bigStart:
+                if (byte == 0x00) {
+                    return bigAfterZero;
+                }
+                if (isHighSurrogate) {
+                    return bigAfterHigh;
+                }
+                return isLowSurrogate ? bigAfterLow : bigAfterOther;
+            case bigAfterZero:
+                return isText(byte) ? bigStart : reject;
+            case bigAfterOther:
+                return bigStart;
+            case bigAfterHigh:
+                return bigPending;
+            case bigPending:
+                return isLowSurrogate ? bigPendingAfterLow : reject;
+            case bigPendingAfterLow:
+                return bigStart;
+            case littleStart:
+                return isText(byte) ? littleAfterText : littleAfterControl;
+            case littleAfterText:
+            case littleAfterControl:
+                if (byte == 0x00) {
+                    return state == littleAfterText ? littleStart : reject;
+                }
+                if (isHighSurrogate) {
+                    return littlePending;
+                }
+                return isLowSurrogate ? reject : littleStart;
+            case littlePending:
+                return littlePendingAfterLow;
+            case littlePendingAfterLow:
+                return isLowSurrogate ? littleStart : reject;
+            default:
+                // afterOther, bigAfterLow and reject: only an unpaired trailing byte could still be accepted.
+                return reject;
+        }
+    }
+
+    constexpr std::array<Utf16Validator::State, Utf16Validator::stateCount * 256>
+    Utf16Validator::buildTransitions() noexcept {
+        std::array<State, stateCount * 256> table{};
+        for (const State state: states) {
+            for (std::size_t byte = 0; byte < 256; byte++) {
+                table[state << 8 | byte] = next(state, static_cast<Point>(byte));
+            }
+        }
+        return table;
+    }
+
+    inline constexpr std::array<Utf16Validator::State, Utf16Validator::stateCount * 256>
+    Utf16Validator::transitions{buildTransitions()};
+}
+
+#endif //UTF16VALIDATOR_HPP
@@ -2,42 +2,89 @@
 #define UTF8SEQUENCE_HPP
 
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <optional>
-#include <variant>
+#include <span>
+#include "../Unicode.hpp"
 
 namespace File::Unicode {
+    // One UTF-8 sequence packed into a single word: the code point decoded so far in the low 21 bits, the
+    // continuation bytes still expected above it and the full length of the sequence at the top. Files are
+    // classified through Utf8Validator, which is built to accept exactly what this does.
     class Utf8Sequence {
-        using Ascii = std::uint8_t;
-        using Western = std::array<std::uint8_t, 2>;
-        using Bmp = std::array<std::uint8_t, 3>;
-        using Other = std::array<std::uint8_t, 4>;
-        using Utf8Type = std::variant<Ascii, Western, Bmp, Other>;
+        static constexpr std::uint32_t codepointMask{0x1F'FFFF};
+        static constexpr unsigned remainingShift{24};
+        static constexpr unsigned lengthShift{28};
+        static constexpr std::array<std::uint32_t, 4> minimums{0x0, 0x80, 0x800, 0x1'0000};
+        static constexpr std::array<std::uint32_t, 4> maximums{0x7F, 0x7FF, 0xFFFF, 0x10'FFFF};
 
-        static constexpr bool isInvalid(std::uint8_t byte) noexcept;
+        std::uint32_t m_state{};
 
-        explicit Utf8Sequence(Utf8Type type);
+        explicit constexpr Utf8Sequence(const std::uint32_t state) noexcept : m_state{state} { }
 
-        Utf8Type m_data;
-        std::uint8_t m_currentLength;
+        [[nodiscard]] static constexpr bool isInvalid(const std::uint8_t byte) noexcept {
+            return byte == 0xC0 || byte == 0xC1 || byte == 0xF5;
+        }
 
-        std::uint8_t& at(std::size_t index);
+        [[nodiscard]] constexpr std::uint32_t codepoint() const noexcept {
+            return m_state & codepointMask;
+        }
 
-        [[nodiscard]] std::size_t fullLen() const;
+        [[nodiscard]] constexpr std::uint32_t remaining() const noexcept {
+            return m_state >> remainingShift & 0xF;
+        }
 
-        std::uint32_t getCodepoint();
+        [[nodiscard]] constexpr std::uint32_t length() const noexcept {
+            return m_state >> lengthShift;
+        }
 
     public:
         using Point = std::uint8_t;
 
-        static std::optional<Utf8Sequence> build(Point byte);
+        [[nodiscard]] static constexpr std::optional<Utf8Sequence> build(Point byte) noexcept;
 
-        [[nodiscard]] bool isComplete() const;
+        [[nodiscard]] constexpr bool isComplete() const noexcept {
+            return remaining() == 0;
+        }
 
-        bool addPoint(Point point);
+        constexpr bool addPoint(Point point) noexcept;
 
-        [[nodiscard]] bool isValid();
+        [[nodiscard]] constexpr bool isValid() const noexcept;
+
+        // Runs validateVle over a block, carrying a sequence left open at its end in pending.
+        static bool consume(std::optional<Utf8Sequence>& pending, std::span<const Point> block) noexcept;
     };
+
+    constexpr std::optional<Utf8Sequence> Utf8Sequence::build(const Point byte) noexcept {
+        if ((0x80 <= byte && byte <= 0xBF) || isInvalid(byte)) {
+            return std::nullopt;
+        }
+        const int leadingOnes{std::countl_one(byte)};
+        if (leadingOnes > 4) {
+            return std::nullopt;
+        }
+        const std::uint32_t length{leadingOnes == 0 ? 1u : static_cast<std::uint32_t>(leadingOnes)};
+        const std::uint32_t payload{byte & 0x7Fu >> leadingOnes};
+        return Utf8Sequence{length << lengthShift | (length - 1) << remainingShift | payload};
+    }
+
+    constexpr bool Utf8Sequence::addPoint(const Point point) noexcept {
+        if (isComplete()) {
+            return false;
+        }
+        if ((0b10'000000 > point || point >= 0b11'000000) || isInvalid(point)) {
+            return false;
+        }
+        const std::uint32_t decoded{codepoint() << 6 | (point & 0b00'111111u)};
+        m_state = length() << lengthShift | (remaining() - 1) << remainingShift | decoded;
+        return true;
+    }
+
+    constexpr bool Utf8Sequence::isValid() const noexcept {
+        const std::uint32_t value{codepoint()};
+        return isComplete() && isText(value) && minimums[length() - 1] <= value && value <= maximums[length() - 1];
+    }
 }
 
 #endif //UTF8SEQUENCE_HPP
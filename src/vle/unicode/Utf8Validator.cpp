@@ -0,0 +1,33 @@
+#include "Utf8Validator.hpp"
+#include <algorithm>
+#include "../../simd/Utf8.hpp"
+
+namespace File::Unicode {
+    Utf8Validator::Utf8Validator() noexcept : Utf8Validator{Simd::detectIsa()} { }
+
+    bool Utf8Validator::consume(std::span<const Point> block) noexcept {
+        // Rejection is sticky, so it is only checked between strides to keep the inner loop branchless.
+        constexpr std::size_t stride{4096};
+        State state{m_state};
+        // Finish any sequence left open by the previous block so the vector kernel starts on a boundary.
+        while (!block.empty() && state != accept && state != reject) {
+            state = step(state, block.front());
+            block = block.subspan(1);
+        }
+        if (state == accept) {
+            const std::optional<std::size_t> checked{Simd::utf8ValidPrefix(block, m_isa)};
+            if (!checked.has_value()) {
+                m_state = reject;
+                return false;
+            }
+            block = block.subspan(*checked);
+        }
+        while (!block.empty() && state != reject) {
+            const std::size_t length{std::min(block.size(), stride)};
+            state = run(state, block.first(length));
+            block = block.subspan(length);
+        }
+        m_state = state;
+        return m_state != reject;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef UTF8VALIDATOR_HPP
+#define UTF8VALIDATOR_HPP
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include "../ShiftDfa.hpp"
+#include "../../simd/Cpu.hpp"
+
+namespace File::Unicode {
+    // The UTF-8 states for ShiftDfa, accepting exactly the byte streams Utf8Sequence accepts.
+    struct Utf8Transitions {
+        static constexpr std::uint64_t accept{0};
+        static constexpr std::uint64_t reject{6};
+        static constexpr std::uint64_t afterC2{12};
+        static constexpr std::uint64_t needOne{18};
+        static constexpr std::uint64_t afterE0{24};
+        static constexpr std::uint64_t needTwo{30};
+        static constexpr std::uint64_t afterF0{36};
+        static constexpr std::uint64_t needThree{42};
+        static constexpr std::uint64_t afterF4{48};
+        static constexpr std::array<std::uint64_t, 9> states{
+            accept, reject, afterC2, needOne, afterE0, needTwo, afterF0, needThree, afterF4
+        };
+
+        static constexpr std::uint64_t next(std::uint64_t state, std::uint8_t byte) noexcept;
+    };
+
+    class Utf8Validator : public ShiftDfa<Utf8Transitions> {
+    public:
+        Utf8Validator() noexcept;
+
+        explicit constexpr Utf8Validator(const Simd::Isa isa) noexcept : ShiftDfa{isa} { }
+
+        bool consume(std::span<const Point> block) noexcept;
+    };
+
+    constexpr std::uint64_t Utf8Transitions::next(const std::uint64_t state, const std::uint8_t byte) noexcept {
+        const bool isContinuation{0x80 <= byte && byte <= 0xBF};
+        switch (state) {
+            case accept:
+                if (byte < 0x80) {
+                    return (0x08 <= byte && byte <= 0x0D) || byte == 0x1B || (0x20 <= byte && byte <= 0x7E)
+                               ? accept
+                               : reject;
+                }
+                if (byte == 0xC2) {
+                    return afterC2;
+                }
+                if (0xC3 <= byte && byte <= 0xDF) {
+                    return needOne;
+                }
+                if (byte == 0xE0) {
+                    return afterE0;
+                }
+                if (0xE1 <= byte && byte <= 0xEF) {
+                    return needTwo;
+                }
+                if (byte == 0xF0) {
+                    return afterF0;
+                }
+                if (0xF1 <= byte && byte <= 0xF3) {
+                    return needThree;
+                }
+                return byte == 0xF4 ? afterF4 : reject;
+            case afterC2:
+                // U+0080 to U+009F are C1 controls, which isText rejects.
+                return 0xA0 <= byte && byte <= 0xBF ? accept : reject;
+            case needOne:
+                return isContinuation ? accept : reject;
+            case afterE0:
+                return 0xA0 <= byte && byte <= 0xBF ? needOne : reject;
+            case needTwo:
+                return isContinuation ? needOne : reject;
+            case afterF0:
+                return 0x90 <= byte && byte <= 0xBF ? needTwo : reject;
+            case needThree:
+                return isContinuation ? needTwo : reject;
+            case afterF4:
+                return 0x80 <= byte && byte <= 0x8F ? needTwo : reject;
+            default:
+                return reject;
+        }
+    }
+}
+
+#endif //UTF8VALIDATOR_HPP
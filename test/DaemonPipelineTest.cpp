@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/FileState.hpp"
+#include "../src/FileType.hpp"
+#include "../src/daemon/Client.hpp"
+#include "../src/daemon/Protocol.hpp"
+#include "../src/daemon/Server.hpp"
+#include "../src/pool/WorkStealingPool.hpp"
+
+// Pipelines far more requests than the socket buffers of both directions hold before reading a single answer,
+// which a client that only sends while flushing would deadlock on, then checks that an oversized request is
+// refused on its own.
+
+namespace {
+    constexpr std::size_t requestCount{2'000'000};
+}
+
+int main() {
+    std::string directory{(std::filesystem::temp_directory_path() / "file_daemon_test.XXXXXX").string()};
+    if (mkdtemp(directory.data()) == nullptr) {
+        std::cerr << "Unable to create a directory for the socket" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path socket{std::filesystem::path{directory} / "socket"};
+    File::WorkStealingPool pool{2};
+    std::optional server{
+        File::Daemon::Server::listen(socket, pool, [](File::Daemon::RequestKind,
+                                                      const std::span<const std::uint8_t> payload) {
+            return File::FileState{payload.size() % 2 == 0 ? File::FileType::ascii : File::FileType::utf8};
+        })
+    };
+    if (!server.has_value()) {
+        std::cerr << "Unable to listen on " << socket << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::thread serving{[&server] { server->run(); }};
+    int failures{0};
+    {
+        std::optional client{File::Daemon::Client::connect(socket)};
+        if (!client.has_value()) {
+            std::cerr << "Unable to connect to " << socket << std::endl;
+            failures++;
+        } else {
+            const std::uint8_t payload[]{'a', 'b', 'c'};
+            for (std::size_t i = 0; i < requestCount; i++) {
+                client->queueBytes(std::span{payload, 1 + i % 2});
+            }
+            if (!client->flush()) {
+                std::cerr << "Flush failed" << std::endl;
+                failures++;
+            }
+            for (std::size_t i = 0; i < requestCount && failures == 0; i++) {
+                const std::optional answer{client->receive()};
+                const File::FileType expected{i % 2 == 1 ? File::FileType::ascii : File::FileType::utf8};
+                if (!answer.has_value() || *answer != File::FileState{expected}) {
+                    std::cerr << "Wrong answer to request " << i << std::endl;
+                    failures++;
+                }
+            }
+            // A payload the server would reject is refused before it can fail the requests pipelined with it.
+            const std::vector<std::uint8_t> oversized(File::Daemon::maximumPayload + std::size_t{1});
+            client->queueBytes(std::span{payload, 2});
+            try {
+                client->queueBytes(oversized);
+                std::cerr << "Oversized payload queued" << std::endl;
+                failures++;
+            } catch (const std::length_error&) { }
+            client->queueBytes(std::span{payload, 1});
+            const bool isFlushed{client->flush()};
+            const std::optional first{client->receive()};
+            const std::optional second{client->receive()};
+            if (!isFlushed || first != File::FileState{File::FileType::ascii} ||
+                second != File::FileState{File::FileType::utf8}) {
+                std::cerr << "Requests around an oversized payload went unanswered" << std::endl;
+                failures++;
+            }
+        }
+    }
+    server->stop();
+    serving.join();
+    server.reset();
+    std::filesystem::remove_all(directory);
+    if (failures != 0) {
+        return EXIT_FAILURE;
+    }
+    std::cout << requestCount << " pipelined requests answered" << std::endl;
+    return EXIT_SUCCESS;
+}
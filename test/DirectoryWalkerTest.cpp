@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "../src/io/DirectoryWalker.hpp"
+#include "../src/pool/WorkStealingPool.hpp"
+
+// Walks one tree as listed by the file system and again with every entry type reported as DT_UNKNOWN, as on
+// file systems that leave d_type unset, and expects the same files under every follow policy.
+
+namespace {
+    struct LinuxDirent64 {
+        ino64_t d_ino;
+        off64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[];
+    };
+
+    bool isHidingTypes{false};
+
+    std::vector<std::string> walk(const std::filesystem::path& root, const File::Io::DirectoryWalker::Follow follow) {
+        File::WorkStealingPool pool{2};
+        File::Io::DirectoryWalker walker{pool, follow, false};
+        std::vector<std::string> paths{};
+        walker.walk(root, [&paths, &root](File::Io::DirectoryWalker::Entry&& entry) {
+            paths.emplace_back(entry.path.lexically_relative(root).generic_string());
+        });
+        pool.wait();
+        return paths;
+    }
+
+    std::string describe(const std::vector<std::string>& paths) {
+        std::string description{};
+        for (const std::string& path: paths) {
+            description.append(" ").append(path);
+        }
+        return description;
+    }
+}
+
+// The walker reads directories through syscall(SYS_getdents64, ...), the only system call this test makes
+// through it, so defining it here stands in for the C library's.
+long syscall(const long number, ...) noexcept {
+    if (number != SYS_getdents64) {
+        errno = ENOSYS;
+        return -1;
+    }
+    va_list arguments;
+    va_start(arguments, number);
+    const int descriptor{va_arg(arguments, int)};
+    char* const buffer{va_arg(arguments, char*)};
+    const std::size_t size{va_arg(arguments, std::size_t)};
+    va_end(arguments);
+    const ssize_t count{getdents64(descriptor, buffer, size)};
+    for (ssize_t offset = 0; isHidingTypes && offset < count;) {
+        auto* entry{reinterpret_cast<LinuxDirent64*>(buffer + offset)};
+        entry->d_type = DT_UNKNOWN;
+        offset += entry->d_reclen;
+    }
+    return count;
+}
+
+int main() {
+    std::string directory{(std::filesystem::temp_directory_path() / "file_walker_test.XXXXXX").string()};
+    if (mkdtemp(directory.data()) == nullptr) {
+        std::cerr << "Unable to create a directory for the tree" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path root{directory};
+    int failures{0};
+    std::filesystem::create_directories(root / "directory" / "nested");
+    std::filesystem::create_directory(root / "outside");
+    for (const std::filesystem::path& file: {root / "file", root / "directory" / "nested" / "file",
+                                             root / "outside" / "file"}) {
+        std::ofstream{file};
+    }
+    std::filesystem::create_symlink("file", root / "link");
+    std::filesystem::create_directory_symlink("../outside", root / "directory" / "linked");
+    std::filesystem::create_symlink("missing", root / "dangling");
+    const std::vector<std::pair<File::Io::DirectoryWalker::Follow, const char*>> policies{
+        {File::Io::DirectoryWalker::Follow::never, "never"},
+        {File::Io::DirectoryWalker::Follow::roots, "roots"},
+        {File::Io::DirectoryWalker::Follow::always, "always"},
+    };
+    for (const auto& [follow, name]: policies) {
+        isHidingTypes = false;
+        const std::vector reported{walk(root, follow)};
+        isHidingTypes = true;
+        const std::vector unknown{walk(root, follow)};
+        if (reported != unknown) {
+            std::cerr << "--follow=" << name << " listed" << describe(reported) << " with entry types but"
+                      << describe(unknown) << " without" << std::endl;
+            failures++;
+        }
+        const bool isFollowingLinks{follow == File::Io::DirectoryWalker::Follow::always};
+        if (isFollowingLinks != (std::ranges::find(unknown, "link") != unknown.end())) {
+            std::cerr << "--follow=" << name << (isFollowingLinks ? " missed" : " followed") << " a link to a file"
+                      << std::endl;
+            failures++;
+        }
+    }
+    std::filesystem::remove_all(root);
+    if (failures != 0) {
+        return EXIT_FAILURE;
+    }
+    std::cout << "Walks agree with and without entry types" << std::endl;
+    return EXIT_SUCCESS;
+}
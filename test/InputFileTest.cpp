@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <unistd.h>
+#include "../src/io/InputFile.hpp"
+
+// Maps a file, cuts it short and reads the whole mapping, which would raise SIGBUS past the new end of the file
+// were the pages there not swapped for zeros.
+
+namespace {
+    constexpr std::size_t fileSize{1024 * 1024};
+    constexpr std::size_t truncatedSize{4096};
+
+    // Every byte of the span, so no page of it goes untouched.
+    std::uint64_t sum(const std::span<const std::uint8_t> bytes) {
+        std::uint64_t total{0};
+        for (const std::uint8_t byte: bytes) {
+            total += byte;
+        }
+        return total;
+    }
+}
+
+int main() {
+    std::string directory{(std::filesystem::temp_directory_path() / "file_input_test.XXXXXX").string()};
+    if (mkdtemp(directory.data()) == nullptr) {
+        std::cerr << "Unable to create a directory for the file" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path path{std::filesystem::path{directory} / "shrinking"};
+    std::ofstream{path, std::ios::binary} << std::string(fileSize, 'a');
+    int failures{0};
+    {
+        std::optional intact{File::Io::InputFile::open(path)};
+        std::optional input{File::Io::InputFile::open(path)};
+        if (!intact.has_value() || !input.has_value() || !input->isMapped()) {
+            std::cerr << "Unable to map " << path << std::endl;
+            std::filesystem::remove_all(directory);
+            return EXIT_FAILURE;
+        }
+        if (sum(intact->next()) != fileSize * 'a' || !intact->isIntact()) {
+            std::cerr << "A file left alone read wrong" << std::endl;
+            failures++;
+        }
+        std::filesystem::resize_file(path, truncatedSize);
+        if (sum(input->next()) != truncatedSize * 'a') {
+            std::cerr << "Pages past the new end did not read as zeros" << std::endl;
+            failures++;
+        }
+        if (input->isIntact()) {
+            std::cerr << "A file cut short under its mapping was taken as intact" << std::endl;
+            failures++;
+        }
+    }
+    std::filesystem::remove_all(directory);
+    if (failures != 0) {
+        return EXIT_FAILURE;
+    }
+    std::cout << "A file cut short under its mapping was detected" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,45 @@
+# Classifies one tree in two shards and merges them. Walked shards print sorted by path and have to merge into
+# the output of an unsharded run; shards fed by --files-from print in list order and have to be refused.
+# Run with -DFILE_BINARY=<the file executable> -DWORK=<a scratch directory>.
+
+function(run_file output)
+    execute_process(COMMAND ${FILE_BINARY} ${ARGN}
+                    WORKING_DIRECTORY ${WORK}
+                    OUTPUT_FILE ${WORK}/${output}
+                    ERROR_VARIABLE error
+                    RESULT_VARIABLE result)
+    set(error "${error}" PARENT_SCOPE)
+    set(result "${result}" PARENT_SCOPE)
+endfunction()
+
+file(REMOVE_RECURSE ${WORK})
+file(MAKE_DIRECTORY ${WORK}/tree/nested)
+set(listed "")
+foreach (name IN ITEMS h g f e d c b a)
+    file(WRITE ${WORK}/tree/${name} "text ${name}\n")
+    file(WRITE ${WORK}/tree/nested/${name} "nested ${name}\n")
+    string(APPEND listed "tree/${name}\ntree/nested/${name}\n")
+endforeach ()
+file(WRITE ${WORK}/list "${listed}")
+
+run_file(whole -r tree)
+run_file(walked1 -r --shard 1/2 tree)
+run_file(walked2 -r --shard 2/2 tree)
+run_file(merged --merge walked1 walked2)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Merging walked shards failed: ${error}")
+endif ()
+file(READ ${WORK}/whole whole)
+file(READ ${WORK}/merged merged)
+if (NOT merged STREQUAL whole)
+    message(FATAL_ERROR "Merged walked shards differ from an unsharded run:\n${merged}")
+endif ()
+
+run_file(listed1 --files-from list --shard 1/2)
+run_file(listed2 --files-from list --shard 2/2)
+run_file(scrambled --merge listed1 listed2)
+if (result EQUAL 0 OR NOT error MATCHES "not sorted by path")
+    message(FATAL_ERROR "Shards in list order were merged (exit ${result}): ${error}")
+endif ()
+
+file(REMOVE_RECURSE ${WORK})